@@ -0,0 +1,116 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+  Compares the throughput of our resampler with libsamplerate for the rates EasyEffects usually deals with. The
+  signal is resampled in blocks of the size of a typical PipeWire quantum, like the plugins do in the realtime thread.
+*/
+
+#include <samplerate.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <span>
+#include <vector>
+#include "resampler.hpp"
+
+namespace {
+
+constexpr size_t block_size = 256U;
+
+constexpr int duration = 20;  // seconds of audio resampled by each test
+
+template <typename Function>
+auto measure(const int& input_rate, Function&& function) -> double {
+  std::mt19937 generator(0U);
+
+  std::uniform_real_distribution<float> distribution(-1.0F, 1.0F);
+
+  std::vector<float> input(static_cast<size_t>(input_rate) * duration);
+
+  for (auto& v : input) {
+    v = distribution(generator);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+
+  for (size_t offset = 0U; offset + block_size <= input.size(); offset += block_size) {
+    function(std::span<const float>{input.data() + offset, block_size});
+  }
+
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  return static_cast<double>(duration) / elapsed.count();
+}
+
+auto measure_resampler(const int& input_rate, const int& output_rate, const Resampler::Quality& quality) -> double {
+  Resampler resampler(input_rate, output_rate, quality);
+
+  std::vector<float> output(resampler.get_max_output_frames(block_size));
+
+  return measure(input_rate, [&](std::span<const float> block) { resampler.process(block, output, false); });
+}
+
+auto measure_libsamplerate(const int& input_rate, const int& output_rate, const int& converter) -> double {
+  SRC_STATE* state = src_new(converter, 1, nullptr);
+
+  std::vector<float> output(2U * block_size * static_cast<size_t>(output_rate) / static_cast<size_t>(input_rate));
+
+  SRC_DATA data{};
+
+  data.src_ratio = static_cast<double>(output_rate) / static_cast<double>(input_rate);
+
+  const auto speed = measure(input_rate, [&](std::span<const float> block) {
+    data.data_in = block.data();
+    data.input_frames = static_cast<long>(block.size());
+    data.data_out = output.data();
+    data.output_frames = static_cast<long>(output.size());
+
+    src_process(state, &data);
+  });
+
+  src_delete(state);
+
+  return speed;
+}
+
+}  // namespace
+
+auto main() -> int {
+  const std::vector<std::pair<int, int>> rates = {{44100, 48000}, {48000, 44100}, {96000, 48000}, {48000, 96000}};
+
+  std::cout << "times faster than realtime, mono, blocks of " << block_size << " frames\n\n";
+
+  for (const auto& [input_rate, output_rate] : rates) {
+    std::cout << input_rate << " -> " << output_rate << " Hz\n";
+
+    std::cout << "  polyphase fastest:           "
+              << measure_resampler(input_rate, output_rate, Resampler::Quality::fastest) << "\n";
+    std::cout << "  polyphase medium:            "
+              << measure_resampler(input_rate, output_rate, Resampler::Quality::medium) << "\n";
+    std::cout << "  libsamplerate sinc fastest:  " << measure_libsamplerate(input_rate, output_rate, SRC_SINC_FASTEST)
+              << "\n";
+    std::cout << "  libsamplerate sinc medium:   "
+              << measure_libsamplerate(input_rate, output_rate, SRC_SINC_MEDIUM_QUALITY) << "\n";
+    std::cout << "  libsamplerate sinc best:     "
+              << measure_libsamplerate(input_rate, output_rate, SRC_SINC_BEST_QUALITY) << "\n\n";
+  }
+
+  return 0;
+}
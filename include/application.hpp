@@ -23,6 +23,8 @@
 #include <glib/gi18n.h>
 #include <string>
 #include "config.h"
+#include "convolver_worker_pool.hpp"
+#include "fork_join.hpp"
 #include "pipe_manager.hpp"
 #include "preferences_window.hpp"
 #include "presets_manager.hpp"
@@ -21,7 +21,10 @@
 #define AUTOGAIN_HPP
 
 #include <ebur128.h>
+#include <array>
+#include <condition_variable>
 #include "plugin_base.hpp"
+#include "ring_buffer.hpp"
 
 class AutoGain : public PluginBase {
  public:
@@ -63,34 +66,84 @@ class AutoGain : public PluginBase {
                     const double&)>
       results;  // range
 
-  double momentary = 0.0;
-  double shortterm = 0.0;
-  double global = 0.0;
-  double relative = 0.0;
-  double range = 0.0;
-  double loudness = 0.0;
+  // Written by the worker thread and read by the main thread
+
+  std::atomic<double> momentary = 0.0;
+  std::atomic<double> shortterm = 0.0;
+  std::atomic<double> global = 0.0;
+  std::atomic<double> relative = 0.0;
+  std::atomic<double> range = 0.0;
+  std::atomic<double> loudness = 0.0;
 
  private:
   bool ebur128_ready = false;
+  bool worker_quit = false;
 
   uint old_rate = 0U;
 
+  /*
+    The realtime thread never waits for the worker. A rate change is handed over through ebur128_rate and
+    rate_changed. Until the worker has resized the ring and cleared the flag the realtime thread does not touch the
+    ring. The settings callbacks hand their changes over the same way.
+  */
+
+  std::atomic<bool> rate_changed = false;
+  std::atomic<bool> reset_history = false;
+
+  std::atomic<uint> ebur128_rate = 0U;
+
+  std::atomic<int> maximum_history = 0;
+
+  int applied_history = -1;  // only used by the worker. It is the window the current states were set up for.
+
   double target = -23.0;  // target loudness level
   double internal_output_gain = 1.0;
+  double gain_smoothing = 1.0;
+
+  static constexpr double gain_time_constant = 0.1;  // seconds
+
+  // How often the worker feeds libebur128. It matches the 100 ms gating block hop used by the standard.
+
+  static constexpr auto worker_period = std::chrono::milliseconds(100);
+
+  std::atomic<double> target_gain = 1.0;
 
   Reference reference = Reference::geometric_mean_msi;
 
   std::vector<float> data;
+  std::vector<float> worker_data;
+
+  RingBuffer<float> ring;
+
+  /*
+    libebur128 ignores ebur128_set_max_history in histogram mode. The maximum-history window is emulated with two
+    states fed with the same audio and restarted every maximum_history seconds, half a window apart. The results are
+    read from the older one through ebur_state, so they cover between half and all of the last window.
+  */
+
+  std::array<ebur128_state*, 2> ebur_states = {nullptr, nullptr};
+
+  std::array<uint64_t, 2> n_frames_fed = {0U, 0U};
 
   ebur128_state* ebur_state = nullptr;
 
-  std::vector<std::thread> mythreads;
+  std::thread worker;
+
+  std::mutex worker_mutex;
 
-  auto init_ebur128() -> bool;
+  std::condition_variable worker_cv;
+
+  auto init_ebur128(const uint& sampling_rate) -> bool;
+
+  static auto create_ebur128_state(const uint& sampling_rate) -> ebur128_state*;
+
+  void rotate_ebur128_states(const uint& sampling_rate);
 
   static auto parse_reference_key(const std::string& key) -> Reference;
 
-  void set_maximum_history(const int& seconds);
+  void work();
+
+  void update_target_gain();
 };
 
 #endif
@@ -24,11 +24,13 @@
 #include <fmt/format.h>
 #include <sigc++/sigc++.h>
 #include <algorithm>
+#include <memory>
 #include <ranges>
 #include <string>
 #include <vector>
 #include "app_tags.hpp"
 #include "util.hpp"
+#include "waveform_pyramid.hpp"
 
 namespace ui::chart {
 
@@ -52,6 +54,10 @@ void set_x_data(Chart* self, const std::vector<float>& x);
 
 void set_y_data(Chart* self, const std::vector<float>& y);
 
+// Plots a long signal through its min/max pyramid. It replaces the x and y data until they are set again.
+
+void set_waveform(Chart* self, std::shared_ptr<const WaveformPyramid> waveform);
+
 void set_background_color(Chart* self, GdkRGBA color);
 
 void set_color(Chart* self, GdkRGBA color);
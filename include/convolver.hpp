@@ -20,10 +20,11 @@
 #ifndef CONVOLVER_HPP
 #define CONVOLVER_HPP
 
-#include <zita-convolver.h>
 #include <algorithm>
 #include <deque>
 #include <sndfile.hh>
+#include "fork_join.hpp"
+#include "partitioned_convolver.hpp"
 #include "plugin_base.hpp"
 #include "resampler.hpp"
 
@@ -53,9 +54,10 @@ class Convolver : public PluginBase {
  private:
   bool kernel_is_initialized = false;
   bool n_samples_is_power_of_2 = true;
-  bool zita_ready = false;
+  bool convolver_ready = false;
   bool ready = false;
   bool notify_latency = false;
+  bool zero_latency = false;
 
   uint blocksize = 512U;
   uint ir_width = 100U;
@@ -69,7 +71,24 @@ class Convolver : public PluginBase {
 
   std::deque<float> deque_out_L, deque_out_R;
 
-  Convproc* conv = nullptr;
+  /*
+    Zero latency mode. The first head_size taps of the impulse are convolved directly in the realtime thread. The
+    remaining taps are given to the partitioned convolver in blocks of head_size samples. Delaying its output by
+    exactly head_size samples lines the tail up with the end of the head, so the sum is the full convolution without
+    added latency.
+  */
+
+  static constexpr uint head_size = 256U;
+
+  uint tail_in_count = 0U;
+  uint tail_out_count = 0U;
+
+  std::vector<float> head_kernel_L, head_kernel_R;
+  std::vector<float> head_history_L, head_history_R;
+  std::vector<float> tail_in_L, tail_in_R;
+  std::vector<float> tail_out_L, tail_out_R;
+
+  std::unique_ptr<PartitionedConvolver> conv;
 
   std::vector<std::thread> mythreads;
 
@@ -79,33 +98,45 @@ class Convolver : public PluginBase {
 
   void set_kernel_stereo_width();
 
-  void setup_zita();
+  void setup_convolver();
 
-  auto get_zita_buffer_size() -> uint;
+  auto get_convolver_block_size() -> uint;
 
-  template <typename T1>
-  void do_convolution(T1& data_left, T1& data_right) {
-    std::span conv_left_in{conv->inpdata(0), conv->inpdata(0) + get_zita_buffer_size()};
-    std::span conv_right_in{conv->inpdata(1), conv->inpdata(1) + get_zita_buffer_size()};
+  void setup_zero_latency_buffers();
+
+  void process_zero_latency(std::span<float>& left_out, std::span<float>& right_out);
+
+  /*
+    Direct form FIR over the head taps. The history buffer holds the last head_size - 1 input samples followed by the
+    current block. Looping over the taps in the outer loop leaves a plain multiply-add over contiguous samples in the
+    inner loop, which the compiler turns into SIMD instructions.
+  */
 
-    std::span conv_left_out{conv->outdata(0), conv->outdata(0) + get_zita_buffer_size()};
-    std::span conv_right_out{conv->outdata(1), conv->outdata(1) + get_zita_buffer_size()};
+  static void direct_fir(const std::vector<float>& kernel, std::vector<float>& history, std::span<float>& data) {
+    const size_t offset = kernel.size() - 1U;
 
-    std::copy(data_left.begin(), data_left.end(), conv_left_in.begin());
-    std::copy(data_right.begin(), data_right.end(), conv_right_in.begin());
+    std::copy(data.begin(), data.end(), history.begin() + offset);
 
-    if (zita_ready) {
-      const int& ret = conv->process(true);  // thread sync mode set to true
+    std::ranges::fill(data, 0.0F);
 
-      if (ret != 0) {
-        util::debug(log_tag + "IR: process failed: " + util::to_string(ret, ""));
+    for (size_t k = 0U; k < kernel.size(); k++) {
+      const float h = kernel[k];
 
-        zita_ready = false;
-      } else {
-        std::copy(conv_left_out.begin(), conv_left_out.end(), data_left.begin());
-        std::copy(conv_right_out.begin(), conv_right_out.end(), data_right.begin());
+      const float* x = history.data() + offset - k;
+
+      for (size_t n = 0U; n < data.size(); n++) {
+        data[n] += h * x[n];
       }
     }
+
+    std::copy(history.begin() + data.size(), history.begin() + data.size() + offset, history.begin());
+  }
+
+  template <typename T1>
+  void do_convolution(T1& data_left, T1& data_right) {
+    if (convolver_ready) {
+      conv->process(data_left, data_right);
+    }
   }
 };
 
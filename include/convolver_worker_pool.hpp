@@ -0,0 +1,163 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONVOLVER_WORKER_POOL_HPP
+#define CONVOLVER_WORKER_POOL_HPP
+
+#include <pthread.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <vector>
+#include "util.hpp"
+
+/*
+  A single pool of threads shared by every convolution engine in the process. Engines submit partition jobs that have
+  to be finished before their next processing cycle. If a job is not done when the realtime thread needs it the job
+  is run by the realtime thread itself and a deadline miss is counted. This way a busy or slow pool never causes
+  gaps in the audio. At worst the work is done serially, as it would be without the pool.
+
+  The queue is a bounded lock-free ring and the workers sleep on a semaphore, so submitting a job never takes a lock.
+  A job that a worker is already running can not be taken back. The realtime thread spins for it for at most
+  wait_spin_duration and then sleeps on the job state until the worker is done. That is only safe because a worker
+  never runs a job below the priority of the thread that submitted it. The workers raise themselves to the highest
+  realtime priority seen in submit() before they take a job. If the system does not allow it, jobs submitted by
+  realtime threads are not queued anymore and the submitting thread runs them itself.
+*/
+
+class ConvolverWorkerPool {
+ public:
+  ConvolverWorkerPool(const ConvolverWorkerPool&) = delete;
+  auto operator=(const ConvolverWorkerPool&) -> ConvolverWorkerPool& = delete;
+  ConvolverWorkerPool(const ConvolverWorkerPool&&) = delete;
+  auto operator=(const ConvolverWorkerPool&&) -> ConvolverWorkerPool& = delete;
+
+  enum class JobState { idle, queued, running, done };
+
+  class Job {
+   public:
+    Job() = default;
+    Job(const Job&) = delete;
+    auto operator=(const Job&) -> Job& = delete;
+    Job(const Job&&) = delete;
+    auto operator=(const Job&&) -> Job& = delete;
+    virtual ~Job() = default;
+
+    virtual void run() = 0;
+
+    std::atomic<JobState> state = JobState::idle;
+
+    // How many queue entries point to this job. The job can only be destroyed when none is left.
+
+    std::atomic<uint> n_entries = 0U;
+  };
+
+  static auto get() -> ConvolverWorkerPool&;
+
+  /*
+    Thread count and priority. The priority is a minimum. The workers use SCHED_FIFO with the higher of it and the
+    priority of the realtime threads that submit jobs. Changing them restarts the threads. Jobs that are queued
+    during the restart are not lost.
+  */
+
+  void set_n_threads(const uint& value);
+
+  void set_priority(const int& value);
+
+  // These methods do not allocate memory and can be called from the realtime thread
+
+  void submit(Job* job);
+
+  void wait(Job* job);
+
+  // It has to be called before a job is destroyed
+
+  void cancel(Job* job);
+
+  [[nodiscard]] auto get_n_threads() const -> uint;
+
+  [[nodiscard]] auto get_queue_depth() const -> uint;
+
+  [[nodiscard]] auto get_max_queue_depth() const -> uint;
+
+  [[nodiscard]] auto get_deadline_misses() const -> uint64_t;
+
+  [[nodiscard]] auto get_jobs_done() const -> uint64_t;
+
+ private:
+  ConvolverWorkerPool();
+  ~ConvolverWorkerPool();
+
+  const std::string log_tag = "convolver_worker_pool: ";
+
+  static constexpr uint queue_capacity = 256U;  // it has to be a power of two
+
+  static constexpr auto wait_spin_duration = std::chrono::microseconds(200);
+
+  struct Slot {
+    std::atomic<uint> sequence = 0U;
+
+    Job* job = nullptr;
+  };
+
+  std::atomic<bool> stop = false;
+
+  uint n_threads = 0U;
+
+  std::atomic<int> priority = 0;            // the setting
+  std::atomic<int> caller_priority = 0;     // highest priority of the threads that called submit
+  std::atomic<bool> priority_denied = false;  // a worker could not get the priority it needed
+
+  std::atomic<uint> enqueue_position = 0U;
+  std::atomic<uint> dequeue_position = 0U;
+
+  std::atomic<uint> queue_size = 0U;
+  std::atomic<uint> max_queue_size = 0U;
+
+  std::atomic<uint64_t> deadline_misses = 0U;
+  std::atomic<uint64_t> jobs_done = 0U;
+
+  std::vector<Slot> queue;
+
+  std::vector<std::thread> threads;
+
+  std::mutex threads_mutex;
+
+  std::counting_semaphore<> work_available{0};
+
+  void start_threads();
+
+  void stop_threads();
+
+  void worker();
+
+  void apply_priority(int& applied_priority);
+
+  auto push(Job* job) -> bool;
+
+  auto pop() -> Job*;
+
+  void process_entry(Job* job);
+
+  void run_job(Job* job);
+};
+
+#endif
@@ -21,9 +21,7 @@
 #define CRYSTALIZER_HPP
 
 #include <deque>
-#include "fir_filter_bandpass.hpp"
-#include "fir_filter_highpass.hpp"
-#include "fir_filter_lowpass.hpp"
+#include "fir_filter_bank.hpp"
 #include "plugin_base.hpp"
 
 class Crystalizer : public PluginBase {
@@ -55,7 +53,6 @@ class Crystalizer : public PluginBase {
   bool n_samples_is_power_of_2 = true;
   bool filters_are_ready = false;
   bool notify_latency = false;
-  bool do_first_rotation = true;
 
   uint blocksize = 512U;
   uint latency_n_frames = 0U;
@@ -64,6 +61,17 @@ class Crystalizer : public PluginBase {
 
   static constexpr uint nbands = 13U;
 
+  /*
+    The second derivative is calculated through the central difference method. In order to calculate it at the last
+    element of the block we would have to know the first element of the next one. As we do not have it the signal is
+    delayed by one sample. Each band is stored after the last two samples of its previous block. This way the
+    derivative of every sample can be computed without special cases for the block edges.
+  */
+
+  static constexpr uint band_history = 2U;
+
+  uint band_stride = 0U;
+
   std::vector<float> data_L;
   std::vector<float> data_R;
 
@@ -72,146 +80,86 @@ class Crystalizer : public PluginBase {
 
   std::array<float, nbands + 1U> frequencies;
   std::array<float, nbands> band_intensity;
-  std::array<float, nbands> band_last_L;
-  std::array<float, nbands> band_last_R;
-  std::array<float, nbands> band_next_L;
-  std::array<float, nbands> band_next_R;
 
-  std::array<std::vector<float>, nbands> band_data_L;
-  std::array<std::vector<float>, nbands> band_data_R;
-  std::array<std::vector<float>, nbands> band_gain;
-  std::array<std::vector<float>, nbands> band_second_derivative_L;
-  std::array<std::vector<float>, nbands> band_second_derivative_R;
+  std::array<uint, nbands> enhanced_bands;
+  std::array<uint, nbands> bypassed_bands;
+
+  std::vector<float> band_data_L, band_data_R;  // nbands blocks of band_stride samples
 
-  std::array<std::unique_ptr<FirFilterBase>, nbands> filters;
+  std::vector<float> bypass_data_L, bypass_data_R;  // bypassed bands sum preceded by its last sample
+
+  std::unique_ptr<FirFilterBank> filter_bank;
 
   std::deque<float> deque_out_L, deque_out_R;
 
   void bind_band(const int& n);
 
+  static void add_enhanced_band(const float* band, const float& intensity, float* output, const uint& size) {
+    for (uint m = 0U; m < size; m++) {
+      output[m] += band[m + 1U] - intensity * (band[m + 2U] - 2.0F * band[m + 1U] + band[m]);
+    }
+  }
+
   template <typename T1>
   void enhance_peaks(T1& data_left, T1& data_right) {
-    for (uint n = 0U; n < nbands; n++) {
-      std::copy(data_left.begin(), data_left.end(), band_data_L.at(n).begin());
-      std::copy(data_right.begin(), data_right.end(), band_data_R.at(n).begin());
-
-      filters.at(n)->process(band_data_L.at(n), band_data_R.at(n));
-
-      /*
-        Later we will need to calculate the second derivative of each band. This
-        is done through the central difference method. In order to calculate
-        the derivative at the last elements of the array we have to know the first
-        element of the next buffer. As we do not have this information the only
-        way to do this calculation is delaying the signal by 1 sample.
-      */
-
-      // last (R,L) becomes the first
-
-      std::rotate(band_data_L.at(n).rbegin(), band_data_L.at(n).rbegin() + 1, band_data_L.at(n).rend());
-      std::rotate(band_data_R.at(n).rbegin(), band_data_R.at(n).rbegin() + 1, band_data_R.at(n).rend());
-
-      if (do_first_rotation) {
-        /*
-          band_data was rotated. Its first values are the last ones from the original array. we have to save them for
-          the next round.
-        */
+    filter_bank->push(data_left, data_right);
 
-        band_next_L.at(n) = band_data_L.at(n)[0];
-        band_next_R.at(n) = band_data_R.at(n)[0];
+    uint n_enhanced = 0U;
+    uint n_bypassed = 0U;
 
-        band_last_L.at(n) = 0.0F;
-        band_last_R.at(n) = 0.0F;
-
-        band_data_L.at(n)[0] = 0.0F;
-        band_data_R.at(n)[0] = 0.0F;
+    for (uint n = 0U; n < nbands; n++) {
+      if (band_mute[n]) {
+        continue;
+      }
 
-        do_first_rotation = false;
+      if (band_bypass[n]) {
+        bypassed_bands[n_bypassed++] = n;
       } else {
-        /*
-          band_data was rotated. Its first values are the last ones from the original array. we have to save them for
-          the next round.
-        */
+        enhanced_bands[n_enhanced++] = n;
+      }
+    }
 
-        const float L = band_data_L.at(n)[0];
-        const float R = band_data_R.at(n)[0];
+    // the bypassed bands are not enhanced. Only their delayed sum is needed
 
-        band_data_L.at(n)[0] = band_next_L.at(n);
-        band_data_R.at(n)[0] = band_next_R.at(n);
+    bypass_data_L[0] = bypass_data_L[blocksize];
+    bypass_data_R[0] = bypass_data_R[blocksize];
 
-        band_next_L.at(n) = L;
-        band_next_R.at(n) = R;
-      }
+    if (n_bypassed != 0U) {
+      filter_bank->get_output(std::span{bypassed_bands.data(), n_bypassed}, bypass_data_L.data() + 1U,
+                              bypass_data_R.data() + 1U);
+    } else {
+      std::fill(bypass_data_L.begin() + 1U, bypass_data_L.end(), 0.0F);
+      std::fill(bypass_data_R.begin() + 1U, bypass_data_R.end(), 0.0F);
     }
 
+    std::copy_n(bypass_data_L.begin(), blocksize, data_left.begin());
+    std::copy_n(bypass_data_R.begin(), blocksize, data_right.begin());
+
+    // muted bands are not filtered at all. Their history is cleared so they restart from silence
+
     for (uint n = 0U; n < nbands; n++) {
-      // Calculating the second derivative
-
-      if (!band_bypass.at(n)) {
-        for (uint m = 0U; m < blocksize; m++) {
-          const float L = band_data_L.at(n)[m];
-          const float R = band_data_R.at(n)[m];
-
-          if (m > 0 && m < blocksize - 1) {
-            const float& L_lower = band_data_L.at(n)[m - 1U];
-            const float& R_lower = band_data_R.at(n)[m - 1U];
-            const float& L_upper = band_data_L.at(n)[m + 1U];
-            const float& R_upper = band_data_R.at(n)[m + 1U];
-
-            band_second_derivative_L.at(n)[m] = L_upper - 2.0F * L + L_lower;
-            band_second_derivative_R.at(n)[m] = R_upper - 2.0F * R + R_lower;
-          } else if (m == 0U) {
-            const float& L_lower = band_last_L.at(n);
-            const float& R_lower = band_last_R.at(n);
-            const float& L_upper = band_data_L.at(n)[m + 1];
-            const float& R_upper = band_data_R.at(n)[m + 1];
-
-            band_second_derivative_L.at(n)[m] = L_upper - 2.0F * L + L_lower;
-            band_second_derivative_R.at(n)[m] = R_upper - 2.0F * R + R_lower;
-          } else if (m == blocksize - 1) {
-            const float& L_upper = band_next_L.at(n);
-            const float& R_upper = band_next_R.at(n);
-            const float& L_lower = band_data_L.at(n)[m - 1U];
-            const float& R_lower = band_data_R.at(n)[m - 1U];
-
-            band_second_derivative_L.at(n)[m] = L_upper - 2.0F * L + L_lower;
-            band_second_derivative_R.at(n)[m] = R_upper - 2.0F * R + R_lower;
-          }
-        }
-
-        // peak enhancing using second derivative
-
-        for (uint m = 0U; m < blocksize; m++) {
-          const float L = band_data_L.at(n)[m];
-          const float R = band_data_R.at(n)[m];
-          const float& d2L = band_second_derivative_L.at(n)[m];
-          const float& d2R = band_second_derivative_R.at(n)[m];
-
-          band_data_L.at(n)[m] = L - band_intensity.at(n) * d2L;
-          band_data_R.at(n)[m] = R - band_intensity.at(n) * d2R;
-
-          if (m == blocksize - 1U) {
-            band_last_L.at(n) = L;
-            band_last_R.at(n) = R;
-          }
-        }
-      } else {
-        band_last_L.at(n) = band_data_L.at(n)[blocksize - 1];
-        band_last_R.at(n) = band_data_R.at(n)[blocksize - 1];
+      if (band_mute[n] || band_bypass[n]) {
+        std::fill_n(band_data_L.begin() + n * band_stride, band_history, 0.0F);
+        std::fill_n(band_data_R.begin() + n * band_stride, band_history, 0.0F);
       }
     }
 
-    // add bands
+    // peak enhancing using the second derivative and summing the bands in the same pass
 
-    for (uint m = 0U; m < blocksize; m++) {
-      data_left[m] = 0.0F;
-      data_right[m] = 0.0F;
+    for (uint i = 0U; i < n_enhanced; i++) {
+      const auto n = enhanced_bands[i];
 
-      for (uint n = 0; n < nbands; n++) {
-        if (!band_mute.at(n)) {
-          data_left[m] += band_data_L.at(n)[m];
-          data_right[m] += band_data_R.at(n)[m];
-        }
-      }
+      float* band_L = band_data_L.data() + n * band_stride;
+      float* band_R = band_data_R.data() + n * band_stride;
+
+      filter_bank->get_output(std::span{enhanced_bands.data() + i, 1U}, band_L + band_history,
+                              band_R + band_history);
+
+      add_enhanced_band(band_L, band_intensity[n], data_left.data(), blocksize);
+      add_enhanced_band(band_R, band_intensity[n], data_right.data(), blocksize);
+
+      std::copy_n(band_L + blocksize, band_history, band_L);
+      std::copy_n(band_R + blocksize, band_history, band_R);
     }
   }
 };
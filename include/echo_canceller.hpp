@@ -21,8 +21,10 @@
 #define ECHO_CANCELLER_HPP
 
 #include <speex/speex_echo.h>
-#include <deque>
+#include "echo_delay_estimator.hpp"
+#include "fork_join.hpp"
 #include "plugin_base.hpp"
+#include "ring_buffer.hpp"
 
 class EchoCanceller : public PluginBase {
  public:
@@ -49,6 +51,8 @@ class EchoCanceller : public PluginBase {
 
   sigc::signal<void(const float&)> latency;
 
+  sigc::signal<void(const float&)> probe_delay;  // seconds
+
  private:
   bool notify_latency = false;
   bool ready = false;
@@ -57,24 +61,47 @@ class EchoCanceller : public PluginBase {
   uint blocksize_ms = 20U;
   uint filter_length_ms = 100U;
   uint latency_n_frames = 0U;
+  uint block_fill = 0U;  // frames already copied to the current block
+  uint probe_delay_n_frames = 0U;
+  uint probe_delay_write = 0U;
 
   float latency_value = 0.0F;
 
-  const float inv_short_max = 1.0F / (SHRT_MAX + 1);
+  /*
+    One mono Speex state per channel. A single speex_echo_state_init_mc state with two microphones and two speakers
+    would also model the crosstalk paths, which is four adaptive filters instead of two and about twice the work per
+    block. The two mono states also run in parallel through ForkJoin.
+  */
+
+  std::vector<spx_int16_t> data_L, data_R;
+  std::vector<spx_int16_t> probe_L, probe_R;
+  std::vector<spx_int16_t> filtered_s16_L, filtered_s16_R;
+
+  std::vector<float> filtered_L, filtered_R;
+
+  RingBuffer<float> ring_out_L, ring_out_R;
+
+  /*
+    The probe is delayed by the bulk echo path delay found by the estimator. The adaptive filter then only has to
+    model the tail of the echo, so filter-length can be much shorter than the device round trip.
+  */
 
-  std::vector<spx_int16_t> data_L;
-  std::vector<spx_int16_t> data_R;
-  std::vector<spx_int16_t> probe_L;
-  std::vector<spx_int16_t> probe_R;
-  std::vector<spx_int16_t> filtered_L;
-  std::vector<spx_int16_t> filtered_R;
+  bool automatic_delay = false;
 
-  std::deque<float> deque_out_L, deque_out_R;
+  static constexpr float probe_delay_margin = 0.005F;  // seconds kept in front of the estimated delay
+
+  std::vector<float> probe_delay_L, probe_delay_R;
+
+  EchoDelayEstimator delay_estimator;
 
   SpeexEchoState* echo_state_L = nullptr;
   SpeexEchoState* echo_state_R = nullptr;
 
   void init_speex();
+
+  void update_probe_delay();
+
+  void delay_probe(std::span<float>& probe_left, std::span<float>& probe_right);
 };
 
 #endif
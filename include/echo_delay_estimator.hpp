@@ -0,0 +1,128 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ECHO_DELAY_ESTIMATOR_HPP
+#define ECHO_DELAY_ESTIMATOR_HPP
+
+#include <fftw3.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+#include "ring_buffer.hpp"
+#include "util.hpp"
+
+/*
+  Measures the bulk delay between the probe, which is what the output device plays, and the microphone signal. The
+  realtime thread only downmixes and decimates both signals to roughly 8 kHz and pushes them into ring buffers. A
+  worker thread cross-correlates about one second of each with a phase transform (GCC-PHAT) and looks for the lag of
+  the correlation peak.
+
+  An estimate is only published after it was found a few times in a row. Until then get_delay_frames() returns -1.
+*/
+
+class EchoDelayEstimator {
+ public:
+  EchoDelayEstimator();
+  EchoDelayEstimator(const EchoDelayEstimator&) = delete;
+  auto operator=(const EchoDelayEstimator&) -> EchoDelayEstimator& = delete;
+  EchoDelayEstimator(const EchoDelayEstimator&&) = delete;
+  auto operator=(const EchoDelayEstimator&&) -> EchoDelayEstimator& = delete;
+  ~EchoDelayEstimator();
+
+  static constexpr float max_delay_seconds = 0.5F;
+
+  // Starts or stops the worker thread. Must be called from the main thread.
+
+  void set_enabled(const bool& value);
+
+  // The next functions are meant for the realtime thread
+
+  void set_rate(const uint& rate, const uint& n_samples);
+
+  void push(std::span<const float> left_in,
+            std::span<const float> right_in,
+            std::span<const float> probe_left,
+            std::span<const float> probe_right);
+
+  [[nodiscard]] auto get_delay_frames() const -> int;
+
+ private:
+  const std::string log_tag = "echo_delay_estimator: ";
+
+  static constexpr uint target_rate = 8000U;
+  static constexpr uint segment_size = 8192U;
+  static constexpr uint fft_size = 2U * segment_size;  // zero padded so that the correlation is linear
+  static constexpr uint n_bins = fft_size / 2U + 1U;
+  static constexpr uint n_confirmations = 3U;
+
+  static constexpr float min_peak_ratio = 8.0F;  // peak over the mean absolute correlation
+  static constexpr float min_probe_rms = 1e-4F;
+
+  bool quit = false;
+
+  uint worker_generation = 0U;
+  uint confirmations = 0U;
+
+  int candidate = -1;
+
+  uint decimation = 1U;  // owned by the realtime thread
+  uint decimation_count = 0U;
+
+  float near_sum = 0.0F, far_sum = 0.0F;
+
+  std::atomic<bool> enabled = false;
+
+  std::atomic<uint> max_lag = 0U;
+  std::atomic<uint> generation = 0U;
+  std::atomic<int> delay = -1;  // in decimated samples
+
+  std::vector<float> near_segment, far_segment;
+  std::vector<float> near_decimated, far_decimated;  // scratch space for the realtime thread
+
+  RingBuffer<float> ring_near, ring_far;
+
+  float* time_data = nullptr;
+  float* correlation = nullptr;
+
+  fftwf_complex* near_spectrum = nullptr;
+  fftwf_complex* far_spectrum = nullptr;
+  fftwf_complex* average = nullptr;  // smoothed and normalized cross spectrum
+
+  fftwf_plan forward_plan = nullptr;
+  fftwf_plan backward_plan = nullptr;
+
+  std::thread worker;
+
+  std::mutex worker_mutex;
+
+  std::condition_variable worker_cv;
+
+  void work();
+
+  void reset_worker_state();
+
+  // Returns the lag of the correlation peak in decimated samples or -1 when the peak is not clear enough
+
+  auto estimate() -> int;
+};
+
+#endif
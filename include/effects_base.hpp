@@ -20,6 +20,7 @@
 #ifndef EFFECTS_BASE_HPP
 #define EFFECTS_BASE_HPP
 
+#include <compare>
 #include <set>
 #include "autogain.hpp"
 #include "bass_enhancer.hpp"
@@ -36,6 +37,7 @@
 #include "filter.hpp"
 #include "gate.hpp"
 #include "limiter.hpp"
+#include "link_transaction.hpp"
 #include "loudness.hpp"
 #include "maximizer.hpp"
 #include "multiband_compressor.hpp"
@@ -104,7 +106,25 @@ class EffectsBase {
 
   std::map<std::string, std::shared_ptr<PluginBase>> plugins;
 
-  std::vector<pw_proxy*> list_proxies, list_proxies_listen_mic;
+  /*
+    A connection between two nodes of the pipeline. Probe edges feed the echo canceller probe with the output device.
+    pipeline_links keeps the link proxies we created for each edge so that a change of the plugins list only touches
+    the edges that changed.
+  */
+
+  struct PipelineEdge {
+    uint output_node_id;
+
+    uint input_node_id;
+
+    bool probe;
+
+    auto operator<=>(const PipelineEdge&) const = default;
+  };
+
+  std::map<PipelineEdge, std::vector<pw_proxy*>> pipeline_links;
+
+  std::vector<pw_proxy*> list_proxies_listen_mic;
 
   std::vector<sigc::connection> connections;
 
@@ -115,6 +135,27 @@ class EffectsBase {
   void deactivate_filters();
 
   void broadcast_pipeline_latency();
+
+  // Appends the edge if the two nodes have ports to link and returns the number of port pairs
+
+  auto add_pipeline_edge(std::vector<PipelineEdge>& edges,
+                         const uint& output_node_id,
+                         const uint& input_node_id,
+                         const bool& probe = false) -> uint;
+
+  /*
+    Creates the links of the edges that are missing from the graph and destroys the ones of the edges that are not in
+    the list anymore. Everything goes in one transaction, so the edges that did not change keep running.
+
+    An old edge is removed before the new ones are created when it goes into a node that also gets a new edge of the
+    same kind, or when a new edge connects its nodes in the opposite direction. Otherwise a node would be fed by two
+    upstream nodes at once or, when plugins swap places, two of them would form a cycle. The other old edges are only
+    removed after the new ones exist, so that a plugin leaving the chain does not interrupt the path.
+  */
+
+  void update_pipeline_links(const std::vector<PipelineEdge>& edges);
+
+  void disconnect_unused_plugins(const std::vector<std::string>& selected_plugins);
 };
 
 #endif
@@ -38,4 +38,8 @@ auto create() -> EqualizerBandBox*;
 
 void setup(EqualizerBandBox* self, GSettings* settings, int index);
 
+// Removes the bindings made by setup so the widget can be reused for another band
+
+void unbind(EqualizerBandBox* self);
+
 }  // namespace ui::equalizer_band_box
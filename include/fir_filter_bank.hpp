@@ -0,0 +1,118 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FIR_FILTER_BANK_HPP
+#define FIR_FILTER_BANK_HPP
+
+#include <fftw3.h>
+#include "fir_filter_base.hpp"
+
+/*
+  Splits a stereo signal in bands using uniformly partitioned overlap-save convolution. Every band shares the forward
+  FFT of the input and its frequency domain delay line. Only the multiplication by the band spectra and the inverse FFT
+  are done per band. Everything runs in the thread calling process. No worker threads are created.
+*/
+
+class FirFilterBank {
+ public:
+  FirFilterBank(std::string tag, const uint& n_bands);
+  FirFilterBank(const FirFilterBank&) = delete;
+  auto operator=(const FirFilterBank&) -> FirFilterBank& = delete;
+  FirFilterBank(const FirFilterBank&&) = delete;
+  auto operator=(const FirFilterBank&&) -> FirFilterBank& = delete;
+  ~FirFilterBank();
+
+  void set_rate(const uint& value);
+
+  void set_n_samples(const uint& value);
+
+  void set_transition_band(const float& value);
+
+  void set_band_frequencies(const uint& band, const float& min_frequency, const float& max_frequency);
+
+  /*
+    fftw planning is not thread safe. This method has to be called from the main thread.
+  */
+
+  void setup();
+
+  [[nodiscard]] auto is_ready() const -> bool;
+
+  [[nodiscard]] auto get_delay() const -> float;
+
+  /*
+    Transforms a block of n_samples and adds it to the delay line. It has to be called once per block before the band
+    outputs are requested.
+  */
+
+  void push(std::span<const float> data_left, std::span<const float> data_right);
+
+  /*
+    Writes the sum of the given bands for the last pushed block. The spectra are added before the inverse FFT, so the
+    cost is a single inverse transform per channel no matter how many bands are summed. Bands that are not requested
+    cost nothing.
+  */
+
+  void get_output(std::span<const uint> bands, float* output_left, float* output_right);
+
+ private:
+  struct Channel {
+    float* window = nullptr;  // previous block followed by the current one
+
+    fftwf_complex* delay_line = nullptr;  // input spectra of the last n_partitions blocks
+
+    uint newest = 0U;
+  };
+
+  const std::string log_tag;
+
+  bool ready = false;
+
+  uint n_bands = 0U;
+  uint n_samples = 0U;
+  uint rate = 0U;
+  uint fft_size = 0U;
+  uint n_bins = 0U;
+  uint bins_stride = 0U;
+  uint n_partitions = 0U;
+
+  float transition_band = 100.0F;  // Hz
+  float delay = 0.0F;
+
+  std::vector<float> min_frequencies, max_frequencies;
+
+  std::vector<fftwf_complex*> band_spectra;
+
+  Channel channel_L, channel_R;
+
+  fftwf_complex* accumulator = nullptr;
+
+  float* time_output = nullptr;
+
+  fftwf_plan forward_plan = nullptr;
+  fftwf_plan backward_plan = nullptr;
+
+  void free_buffers();
+
+  void push_channel(Channel& channel, std::span<const float> data);
+
+  void get_channel_output(const Channel& channel, std::span<const uint> bands, float* output);
+};
+
+#endif
@@ -20,11 +20,12 @@
 #ifndef FIR_FILTER_BASE_HPP
 #define FIR_FILTER_BASE_HPP
 
-#include <zita-convolver.h>
 #include <algorithm>
 #include <numbers>
 #include <ranges>
 #include <span>
+#include "fir_kernel_cache.hpp"
+#include "partitioned_convolver.hpp"
 #include "util.hpp"
 
 class FirFilterBase {
@@ -52,33 +53,15 @@ class FirFilterBase {
 
   template <typename T1>
   void process(T1& data_left, T1& data_right) {
-    std::span conv_left_in{conv->inpdata(0), conv->inpdata(0) + n_samples};
-    std::span conv_right_in{conv->inpdata(1), conv->inpdata(1) + n_samples};
-
-    std::span conv_left_out{conv->outdata(0), conv->outdata(0) + n_samples};
-    std::span conv_right_out{conv->outdata(1), conv->outdata(1) + n_samples};
-
-    std::copy(data_left.begin(), data_left.end(), conv_left_in.begin());
-    std::copy(data_right.begin(), data_right.end(), conv_right_in.begin());
-
-    if (zita_ready) {
-      const int& ret = conv->process(true);  // thread sync mode set to true
-
-      if (ret != 0) {
-        util::debug(log_tag + "IR: process failed: " + util::to_string(ret, ""));
-
-        zita_ready = false;
-      } else {
-        std::copy(conv_left_out.begin(), conv_left_out.end(), data_left.begin());
-        std::copy(conv_right_out.begin(), conv_right_out.end(), data_right.begin());
-      }
+    if (convolver_ready) {
+      conv->process(data_left, data_right);
     }
   }
 
  protected:
   const std::string log_tag;
 
-  bool zita_ready = false;
+  bool convolver_ready = false;
 
   uint n_samples = 0U;
   uint rate = 0U;
@@ -88,14 +71,11 @@ class FirFilterBase {
   float transition_band = 100.0F;  // Hz
   float delay = 0.0F;
 
-  std::vector<float> kernel;
-
-  Convproc* conv = nullptr;
+  FirKernelCache::Kernel kernel;
 
-  [[nodiscard]] auto create_lowpass_kernel(const float& cutoff, const float& transition_band) const
-      -> std::vector<float>;
+  std::unique_ptr<PartitionedConvolver> conv;
 
-  void setup_zita();
+  void setup_convolver();
 
   static void direct_conv(const std::vector<float>& a, const std::vector<float>& b, std::vector<float>& c);
 };
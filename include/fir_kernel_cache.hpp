@@ -0,0 +1,102 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FIR_KERNEL_CACHE_HPP
+#define FIR_KERNEL_CACHE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numbers>
+#include <span>
+#include <vector>
+#include "util.hpp"
+
+/*
+  Designs the windowed-sinc kernels used by the FIR filters and keeps them while somebody is using them. Filters with
+  the same sample rate, frequencies and transition band get the same immutable kernel. This way the identical
+  crystalizer bands of the input and output pipelines are only designed once.
+*/
+
+class FirKernelCache {
+ public:
+  FirKernelCache(const FirKernelCache&) = delete;
+  auto operator=(const FirKernelCache&) -> FirKernelCache& = delete;
+  FirKernelCache(const FirKernelCache&&) = delete;
+  auto operator=(const FirKernelCache&&) -> FirKernelCache& = delete;
+
+  using Kernel = std::shared_ptr<const std::vector<float>>;
+
+  enum class Type { lowpass, highpass, bandpass };
+
+  static auto get() -> FirKernelCache&;
+
+  // An empty kernel is returned when the rate is 0
+
+  auto get_lowpass(const uint& rate, const float& cutoff, const float& transition_band) -> Kernel;
+
+  auto get_highpass(const uint& rate, const float& cutoff, const float& transition_band) -> Kernel;
+
+  auto get_bandpass(const uint& rate,
+                    const float& min_frequency,
+                    const float& max_frequency,
+                    const float& transition_band) -> Kernel;
+
+ private:
+  FirKernelCache() = default;
+  ~FirKernelCache() = default;
+
+  struct Key {
+    Type type;
+
+    uint rate;
+
+    float min_frequency;
+    float max_frequency;
+    float transition_band;
+
+    auto operator<=>(const Key&) const = default;
+  };
+
+  const std::string log_tag = "fir_kernel_cache: ";
+
+  uint64_t hits = 0U;
+  uint64_t misses = 0U;
+
+  std::map<Key, std::weak_ptr<const std::vector<float>>> kernels;
+
+  std::mutex kernels_mutex;
+
+  auto find_or_design(const Key& key) -> Kernel;
+
+  auto design(const Key& key) -> std::vector<float>;
+
+  static auto design_lowpass(const uint& rate, const float& cutoff, const float& transition_band)
+      -> std::vector<float>;
+
+  static void spectral_inversion(std::vector<float>& kernel) {
+    std::ranges::for_each(kernel, [](auto& v) { v *= -1.0F; });
+
+    kernel[(kernel.size() - 1U) / 2U] += 1.0F;
+  }
+};
+
+#endif
@@ -0,0 +1,136 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FORK_JOIN_HPP
+#define FORK_JOIN_HPP
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "util.hpp"
+
+/*
+  Lets a realtime thread process two independent halves of its work, usually the left and right channels, at the
+  same time. The second half is handed to a helper thread that is already running. It spins for a short while after
+  each task so that the next handoff of the same cycle does not have to wake it up.
+
+  The handoff deadline is the end of the first half. If the helper has not picked the second half up by then the
+  calling thread takes it back and runs it itself, which is what would happen without the helper. Nothing here
+  allocates memory or takes a lock in the realtime path.
+
+  The helper runs with SCHED_FIFO at the priority of the realtime thread that calls it. Until it has that priority
+  the calls run serially, so the realtime thread never waits on a thread the scheduler may preempt. If the helper
+  still needs more than join_spin_duration to finish its half the caller blocks until it is done and the next
+  backoff_cycles calls run serially.
+*/
+
+class ForkJoin {
+ public:
+  ForkJoin(const ForkJoin&) = delete;
+  auto operator=(const ForkJoin&) -> ForkJoin& = delete;
+  ForkJoin(const ForkJoin&&) = delete;
+  auto operator=(const ForkJoin&&) -> ForkJoin& = delete;
+
+  static auto get() -> ForkJoin&;
+
+  // Starts or stops the helper thread. When it is disabled both halves run serially in the calling thread.
+
+  void set_enabled(const bool& value);
+
+  template <typename F1, typename F2>
+  void run(F1&& first, F2&& second) {
+    if (!post(&invoke<F2>, const_cast<void*>(static_cast<const void*>(&second)))) {
+      first();
+      second();
+
+      return;
+    }
+
+    first();
+
+    join();
+  }
+
+  [[nodiscard]] auto get_n_forks() const -> uint64_t;
+
+  [[nodiscard]] auto get_n_fallbacks() const -> uint64_t;
+
+  [[nodiscard]] auto get_n_late() const -> uint64_t;
+
+ private:
+  ForkJoin() = default;
+  ~ForkJoin();
+
+  enum State : int { idle, posted, running, done, retune, quit };
+
+  const std::string log_tag = "fork_join: ";
+
+  static constexpr auto spin_duration = std::chrono::microseconds(200);
+
+  static constexpr auto join_spin_duration = std::chrono::microseconds(500);
+
+  static constexpr uint backoff_cycles = 64U;
+
+  std::atomic<int> state = idle;
+
+  std::atomic<bool> busy = false;      // a caller owns the task slot
+  std::atomic<bool> enabled = false;   // the helper thread is running
+  std::atomic<bool> sleeping = false;  // the helper is blocked waiting for a task
+  std::atomic<bool> joining = false;   // the caller is blocked waiting for the helper to finish
+  std::atomic<bool> stop = false;
+
+  std::atomic<int> requested_priority = 0;  // realtime priority of the callers
+  std::atomic<int> helper_priority = 0;     // realtime priority the helper has
+
+  int failed_priority = -1;  // only used by the helper
+
+  std::atomic<uint> n_serial_cycles = 0U;
+
+  std::atomic<uint64_t> n_forks = 0U;
+  std::atomic<uint64_t> n_fallbacks = 0U;
+  std::atomic<uint64_t> n_late = 0U;
+
+  void (*task)(void*) = nullptr;
+
+  void* task_data = nullptr;
+
+  std::thread helper;
+
+  std::mutex helper_mutex;
+
+  template <typename F>
+  static void invoke(void* data) {
+    (*static_cast<std::remove_reference_t<F>*>(data))();
+  }
+
+  auto post(void (*function)(void*), void* data) -> bool;
+
+  void join();
+
+  void work();
+
+  void apply_priority();
+
+  void start_helper();
+
+  void stop_helper();
+};
+
+#endif
@@ -0,0 +1,91 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LINK_TRANSACTION_HPP
+#define LINK_TRANSACTION_HPP
+
+#include <chrono>
+#include <vector>
+#include "pipe_manager.hpp"
+#include "util.hpp"
+
+/*
+  Collects the links a pipeline rebuild creates and the ones it destroys, and sends all of them to PipeWire under a
+  single lock of the thread loop followed by a single pw_core_sync. Doing one round trip per port pair made a long
+  plugin chain stay broken for dozens of round trips.
+
+  New links are created before the old ones are destroyed so that the graph is never left without a path. Links
+  given to destroy_links_first are the exception: they go away before anything is created, for the cases where the
+  old and the new links can not coexist. The transaction is committed when it goes out of scope if commit was not
+  called before. The proxies of the created
+  links are appended to the vector given to link_nodes, which must stay alive until then.
+*/
+
+class LinkTransaction {
+ public:
+  explicit LinkTransaction(PipeManager* pipe_manager);
+  LinkTransaction(const LinkTransaction&) = delete;
+  auto operator=(const LinkTransaction&) -> LinkTransaction& = delete;
+  LinkTransaction(const LinkTransaction&&) = delete;
+  auto operator=(const LinkTransaction&&) -> LinkTransaction& = delete;
+  ~LinkTransaction();
+
+  // Queues the links between two nodes and returns how many port pairs matched
+
+  auto link_nodes(const uint& output_node_id,
+                  const uint& input_node_id,
+                  std::vector<pw_proxy*>& proxies,
+                  const bool& probe_link = false,
+                  const bool& link_passive = true) -> uint;
+
+  void destroy_object(const uint& id);
+
+  void destroy_links(const std::vector<pw_proxy*>& list);
+
+  void destroy_links_first(const std::vector<pw_proxy*>& list);
+
+  void commit();
+
+ private:
+  struct PendingLink {
+    uint output_node_id;
+
+    uint output_port_id;
+
+    uint input_node_id;
+
+    uint input_port_id;
+
+    bool passive;
+
+    std::vector<pw_proxy*>* proxies;
+  };
+
+  PipeManager* pm = nullptr;
+
+  std::vector<PendingLink> pending_links;
+
+  std::vector<uint> pending_objects;
+
+  std::vector<pw_proxy*> pending_proxies, early_proxies;
+
+  std::chrono::time_point<std::chrono::steady_clock> start_time;
+};
+
+#endif
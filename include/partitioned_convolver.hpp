@@ -0,0 +1,124 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARTITIONED_CONVOLVER_HPP
+#define PARTITIONED_CONVOLVER_HPP
+
+#include <fftw3.h>
+#include <algorithm>
+#include <array>
+#include <span>
+#include "convolver_worker_pool.hpp"
+
+/*
+  Stereo uniformly partitioned overlap-save convolution without added latency. The output of a block is
+
+    Y(t) = X(t) * H(0) + sum_{p >= 1} X(t - p) * H(p)
+
+  The sum only depends on blocks that were already received. It is submitted as a job to the shared worker pool right
+  after a block is processed and it is collected in the next cycle. The realtime thread only does one forward FFT, one
+  partition product and one inverse FFT per channel.
+*/
+
+class PartitionedConvolver {
+ public:
+  PartitionedConvolver(std::string tag);
+  PartitionedConvolver(const PartitionedConvolver&) = delete;
+  auto operator=(const PartitionedConvolver&) -> PartitionedConvolver& = delete;
+  PartitionedConvolver(const PartitionedConvolver&&) = delete;
+  auto operator=(const PartitionedConvolver&&) -> PartitionedConvolver& = delete;
+  ~PartitionedConvolver();
+
+  /*
+    fftw planning is not thread safe. This method has to be called from the main thread while process is not being
+    called.
+  */
+
+  auto configure(const uint& block_size, std::span<const float> kernel_left, std::span<const float> kernel_right)
+      -> bool;
+
+  [[nodiscard]] auto is_ready() const -> bool;
+
+  [[nodiscard]] auto get_block_size() const -> uint;
+
+  // Both spans must have block_size samples. The convolution output replaces the input.
+
+  void process(std::span<float> data_left, std::span<float> data_right);
+
+ private:
+  class TailJob : public ConvolverWorkerPool::Job {
+   public:
+    explicit TailJob(PartitionedConvolver* convolver) : convolver(convolver) {}
+
+    void run() override { convolver->compute_tail(); }
+
+   private:
+    PartitionedConvolver* convolver;
+  };
+
+  struct Channel {
+    float* window = nullptr;  // previous block followed by the current one
+
+    float* time_output = nullptr;
+
+    fftwf_complex* delay_line = nullptr;  // input spectra of the last n_partitions blocks
+
+    fftwf_complex* kernel = nullptr;  // spectra of the kernel partitions
+
+    fftwf_complex* accumulator = nullptr;
+
+    fftwf_complex* tail = nullptr;  // written by the tail job
+  };
+
+  const std::string log_tag;
+
+  bool ready = false;
+  bool tail_submitted = false;
+
+  uint block_size = 0U;
+  uint fft_size = 0U;
+  uint n_bins = 0U;
+  uint bins_stride = 0U;
+  uint n_partitions = 0U;
+  uint newest = 0U;
+  uint tail_base = 0U;
+
+  std::array<Channel, 2U> channels;
+
+  fftwf_plan forward_plan = nullptr;
+  fftwf_plan backward_plan = nullptr;
+
+  TailJob tail_job;
+
+  void free_buffers();
+
+  void compute_tail();
+
+  static void multiply_accumulate(const fftwf_complex* a,
+                                  const fftwf_complex* b,
+                                  fftwf_complex* output,
+                                  const uint& size) {
+    for (uint k = 0U; k < size; k++) {
+      output[k][0] += a[k][0] * b[k][0] - a[k][1] * b[k][1];
+      output[k][1] += a[k][0] * b[k][1] + a[k][1] * b[k][0];
+    }
+  }
+};
+
+#endif
@@ -29,8 +29,13 @@
 #include <spa/utils/result.h>
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include "app_tags.hpp"
 #include "util.hpp"
 
@@ -102,6 +107,12 @@ struct LinkInfo {
   pw_link_state state = PW_LINK_STATE_UNLINKED;
 };
 
+enum class PortDirection : uint8_t { unknown, input, output };
+
+// The channels our linking logic cares about. Everything else is "other" and keeps its name in audio_channel.
+
+enum class AudioChannel : uint8_t { unknown, FL, FR, PROBE_FL, PROBE_FR, other };
+
 struct PortInfo {
   std::string path;
 
@@ -111,7 +122,9 @@ struct PortInfo {
 
   std::string name;
 
-  std::string direction;
+  PortDirection direction = PortDirection::unknown;
+
+  AudioChannel channel = AudioChannel::unknown;
 
   bool physical = false;
 
@@ -202,9 +215,20 @@ class PipeManager {
 
   std::map<uint64_t, NodeInfo> node_map;
 
-  std::vector<LinkInfo> list_links;
+  /*
+    Links and ports are added and removed by the PipeWire thread while the main thread reads them. Both are indexed
+    by node id and guarded by graph_mutex. graph_cv is notified whenever a port shows up.
+  */
 
-  std::vector<PortInfo> list_ports;
+  std::unordered_map<uint64_t, LinkInfo> link_map;  // key is the link serial
+
+  std::unordered_map<uint, std::vector<uint64_t>> node_links;  // serials of the links touching a node
+
+  std::unordered_map<uint, std::vector<PortInfo>> node_ports;
+
+  std::mutex graph_mutex;
+
+  std::condition_variable graph_cv;
 
   std::vector<ModuleInfo> list_modules;
 
@@ -233,6 +257,10 @@ class PipeManager {
                      "libcanberra", "gsd-media-keys", "GNOME Shell", "speech-dispatcher", "speech-dispatcher-dummy",
                      "speech-dispatcher-espeak-ng", "Mutter", "gameoverlayui"});
 
+  // How long we wait for PipeWire to tell us about the ports of a node before giving up on linking it
+
+  constexpr static auto ports_timeout = std::chrono::milliseconds(10000);
+
   std::array<std::string, 1U> blocklist_app_id = {"org.PulseAudio.pavucontrol"};
 
   std::array<std::string, 2U> blocklist_media_role = {"event", "Notification"};
@@ -259,6 +287,17 @@ class PipeManager {
 
   auto count_node_ports(const uint& node_id) -> uint;
 
+  auto get_node_ports(const uint& node_id) -> std::vector<PortInfo>;
+
+  auto get_node_links(const uint& node_id) -> std::vector<LinkInfo>;
+
+  /*
+    Blocks until the node has at least n_ports ports or the timeout expires. Returns false on timeout. It must not be
+    called from the PipeWire thread or with the thread loop locked.
+  */
+
+  auto wait_node_ports(const uint& node_id, const uint& n_ports, const std::chrono::milliseconds& timeout) -> bool;
+
   /*
     Links the output ports of the node output_node_id to the input ports of the node input_node_id
   */
@@ -268,6 +307,19 @@ class PipeManager {
                   const bool& probe_link = false,
                   const bool& link_passive = true) -> std::vector<pw_proxy*>;
 
+  // Pairs of output and input port ids that link_nodes connects. Pipeline rebuilds batch them in a LinkTransaction.
+
+  auto match_ports(const uint& output_node_id, const uint& input_node_id, const bool& probe_link)
+      -> std::vector<std::pair<uint, uint>>;
+
+  // Asks PipeWire for a new link without waiting for it. The thread loop must be locked.
+
+  auto create_link(const uint& output_node_id,
+                   const uint& output_port_id,
+                   const uint& input_node_id,
+                   const uint& input_port_id,
+                   const bool& link_passive) const -> pw_proxy*;
+
   void destroy_object(const int& id) const;
 
   /*
@@ -21,7 +21,10 @@
 #define PITCH_HPP
 
 #include <rubberband/RubberBandStretcher.h>
-#include <deque>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include "plugin_base.hpp"
 
 class Pitch : public PluginBase {
@@ -58,14 +61,36 @@ class Pitch : public PluginBase {
 
   uint latency_n_frames = 0U;
 
-  std::vector<float> data_L, data_R;
+  uint stretcher_generation = 0U;
+
+  /*
+    Output ring buffers. They are sized in setup() so the realtime thread only moves indices around.
+  */
+
+  std::vector<float> ring_L, ring_R;
+
+  size_t ring_read = 0U, ring_write = 0U, ring_count = 0U;
 
   std::array<float*, 2U> stretcher_in = {nullptr, nullptr};
   std::array<float*, 2U> stretcher_out = {nullptr, nullptr};
 
-  std::deque<float> deque_out_L, deque_out_R;
+  std::unique_ptr<RubberBand::RubberBandStretcher> stretcher;
+
+  /*
+    RubberBand instances are built by a single thread that setup() wakes up. Only the latest request is kept, so
+    several rate changes in a row build one instance.
+  */
+
+  std::thread builder;
+
+  std::mutex builder_mutex;
 
-  RubberBand::RubberBandStretcher* stretcher = nullptr;
+  std::condition_variable builder_cv;
+
+  bool builder_quit = false;
+  bool build_requested = false;
+
+  uint build_rate = 0U, build_size = 0U, build_generation = 0U;
 
   Mode mode = Mode::speed;
   Formant formant = Formant::shifted;
@@ -79,7 +104,12 @@ class Pitch : public PluginBase {
 
   double time_ratio = 1.0;
 
-  void init_stretcher();
+  auto build_stretcher(const uint& sampling_rate, const uint& max_process_size)
+      -> std::unique_ptr<RubberBand::RubberBandStretcher>;
+
+  void reset_ring();
+
+  void build_loop();
 
   static auto parse_mode_key(const std::string& key) -> Mode;
   static auto parse_formant_key(const std::string& key) -> Formant;
@@ -93,6 +123,14 @@ class Pitch : public PluginBase {
   void set_detector();
   void set_phase();
   void set_pitch_scale();
+
+  void apply_mode(RubberBand::RubberBandStretcher& s) const;
+  void apply_formant(RubberBand::RubberBandStretcher& s) const;
+  void apply_transients(RubberBand::RubberBandStretcher& s) const;
+  void apply_detector(RubberBand::RubberBandStretcher& s) const;
+  void apply_phase(RubberBand::RubberBandStretcher& s) const;
+  void apply_pitch_scale(RubberBand::RubberBandStretcher& s) const;
+  void apply_options(RubberBand::RubberBandStretcher& s) const;
 };
 
 #endif
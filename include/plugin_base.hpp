@@ -22,11 +22,13 @@
 
 #include <pipewire/filter.h>
 #include <spa/param/latency-utils.h>
+#include <atomic>
 #include <mutex>
 #include <ranges>
 #include <span>
 #include "pipe_manager.hpp"
 #include "plugin_name.hpp"
+#include "spectrum_analyzer.hpp"
 
 class PluginBase {
  public:
@@ -44,6 +46,13 @@ class PluginBase {
 
   struct data;
 
+  // Peak levels in dB published to the UI once per notification window
+
+  struct Levels {
+    float input_left = util::minimum_db_level, input_right = util::minimum_db_level;
+    float output_left = util::minimum_db_level, output_right = util::minimum_db_level;
+  };
+
   struct port {
     struct data* data;
   };
@@ -83,6 +92,10 @@ class PluginBase {
 
   std::vector<float> dummy_left, dummy_right;
 
+  // Spectrum taps on the signal before and after process(). They only cost something while subscribed.
+
+  std::shared_ptr<SpectrumAnalyzer::Tap> input_tap, output_tap;
+
   [[nodiscard]] auto get_node_id() const -> uint;
 
   void set_active(const bool& state) const;
@@ -111,8 +124,13 @@ class PluginBase {
 
   virtual auto get_latency_seconds() -> float;
 
-  sigc::signal<void(const float&, const float&)> input_level;
-  sigc::signal<void(const float&, const float&)> output_level;
+  /*
+    Meant for the main thread. Fills levels with the newest published peaks and returns true if they were published
+    after the ones seen with serial. The UI polls it from the frame clock instead of receiving one idle callback per
+    notification.
+  */
+
+  auto get_levels(Levels& levels, uint& serial) const -> bool;
 
  protected:
   std::mutex data_mutex;
@@ -153,6 +171,11 @@ class PluginBase {
 
   float input_peak_left = util::minimum_linear_level, input_peak_right = util::minimum_linear_level;
   float output_peak_left = util::minimum_linear_level, output_peak_right = util::minimum_linear_level;
+
+  std::atomic<float> input_peak_db_left = util::minimum_db_level, input_peak_db_right = util::minimum_db_level;
+  std::atomic<float> output_peak_db_left = util::minimum_db_level, output_peak_db_right = util::minimum_db_level;
+
+  std::atomic<uint> levels_serial = 0U;
 };
 
 #endif
@@ -23,6 +23,7 @@
 #include "autogain_ui.hpp"
 #include "bass_enhancer_ui.hpp"
 #include "bass_loudness_ui.hpp"
+#include "chart.hpp"
 #include "compressor_ui.hpp"
 #include "convolver_ui.hpp"
 #include "crossfeed_ui.hpp"
@@ -21,56 +21,106 @@
 #define RESAMPLER_HPP
 
 #include <samplerate.h>
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <numeric>
 #include <span>
 #include <vector>
 
 class Resampler {
  public:
-  Resampler(const int& input_rate, const int& output_rate);
+  /*
+    fastest and medium use our polyphase engine when the ratio between the rates is a fraction with small terms, like
+    44.1 <-> 48 kHz or 96 <-> 48 kHz. Other ratios and the best quality use libsamplerate. Higher qualities have
+    longer filters and more latency.
+  */
+
+  enum class Quality { fastest, medium, best };
+
+  Resampler(const int& input_rate, const int& output_rate, const Quality& quality = Quality::fastest);
   Resampler(const Resampler&) = delete;
   auto operator=(const Resampler&) -> Resampler& = delete;
   Resampler(const Resampler&&) = delete;
   auto operator=(const Resampler&&) -> Resampler& = delete;
   ~Resampler();
 
-  template <typename T>
-  auto process(const T& input, const bool& end_of_input) -> std::vector<float> {
-    output.resize(std::ceil(1.5 * resample_ratio * input.size()));
-
-    // The number of frames of data pointed to by data_in
-    src_data.input_frames = input.size();
+  [[nodiscard]] auto is_polyphase() const -> bool;
 
-    // A pointer to the input data samples
-    src_data.data_in = input.data();
+  // Output capacity needed by a process call with input_frames frames
 
-    // Maximum number of frames pointed to by data_out
-    src_data.output_frames = static_cast<long>(output.size());
+  [[nodiscard]] auto get_max_output_frames(const size_t& input_frames) const -> size_t;
 
-    // A pointer to the output data samples
-    src_data.data_out = output.data();
+  /*
+    Writes the resampled data to output and returns the number of frames that were written. Nothing is allocated, so
+    it can be called from the realtime thread as long as the output has get_max_output_frames(input.size()) frames.
+  */
 
-    // Equal to output_sample_rate / input_sample_rate
-    src_data.src_ratio = resample_ratio;
+  auto process(std::span<const float> input, std::span<float> output, const bool& end_of_input) -> size_t;
 
-    // Equal to 0 if more input data is available and 1 otherwise
-    src_data.end_of_input = static_cast<int>(end_of_input);
+  // Convenience for offline work like resampling impulse responses. It allocates the returned vector.
 
-    src_process(src_state, &src_data);
+  template <typename T>
+  auto process(const T& input, const bool& end_of_input) -> std::vector<float> {
+    std::vector<float> output(get_max_output_frames(input.size()));
 
-    output.resize(src_data.output_frames_gen);
+    output.resize(process(std::span<const float>{input.data(), input.size()}, output, end_of_input));
 
     return output;
   }
 
  private:
-  float resample_ratio = 1.0F;
+  static constexpr uint max_polyphase_factor = 160U;
+  static constexpr uint chunk_size = 1024U;
+
+  double resample_ratio = 1.0;
 
   SRC_STATE* src_state = nullptr;
 
   SRC_DATA src_data{};
 
-  std::vector<float> output;
+  /*
+    Polyphase engine. The output rate is upsampling_factor / downsampling_factor times the input rate. Each of the
+    upsampling_factor phases is a set of n_taps coefficients stored in reverse order. An output sample is the dot
+    product of one phase with the last n_taps input samples.
+  */
+
+  uint upsampling_factor = 1U;
+  uint downsampling_factor = 1U;
+  uint n_taps = 0U;
+
+  uint64_t position = 0U;  // of the next output in units of 1 / upsampling_factor input samples
+
+  std::vector<float> coefficients;
+
+  std::vector<float> history;  // the last n_taps - 1 input samples followed by the current chunk
+
+  void setup_polyphase(const uint& taps);
+
+  auto process_polyphase_chunk(std::span<const float> input, std::span<float> output) -> size_t;
+
+  auto process_polyphase(std::span<const float> input, std::span<float> output, const bool& end_of_input) -> size_t;
+
+  static auto bessel_i0(const double& x) -> double;
+
+  /*
+    Eight independent partial sums let the compiler use SIMD registers for the dot product without having to reorder
+    a single floating point accumulation.
+  */
+
+  static auto dot_product(const float* a, const float* b, const uint& size) -> float {
+    std::array<float, 8U> sums{};
+
+    for (uint n = 0U; n < size; n += 8U) {
+      for (uint m = 0U; m < 8U; m++) {
+        sums[m] += a[n + m] * b[n + m];
+      }
+    }
+
+    return ((sums[0] + sums[1]) + (sums[2] + sums[3])) + ((sums[4] + sums[5]) + (sums[6] + sums[7]));
+  }
 };
 
 #endif
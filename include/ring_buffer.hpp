@@ -0,0 +1,114 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <span>
+#include <vector>
+
+/*
+  Single producer and single consumer ring buffer. The producer is usually a realtime thread and the consumer a worker
+  or the main thread. Neither side takes a lock or allocates memory. Only resize() and reset() have to be called while
+  nobody else touches the buffer.
+*/
+
+template <typename T>
+class RingBuffer {
+ public:
+  void resize(const size_t& capacity) {
+    // One slot is kept free so that a full buffer can be told apart from an empty one
+
+    buffer.resize(capacity + 1U);
+
+    reset();
+  }
+
+  void reset() {
+    read_index.store(0U, std::memory_order_relaxed);
+    write_index.store(0U, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto capacity() const -> size_t { return (buffer.empty()) ? 0U : buffer.size() - 1U; }
+
+  [[nodiscard]] auto read_available() const -> size_t {
+    const auto w = write_index.load(std::memory_order_acquire);
+    const auto r = read_index.load(std::memory_order_acquire);
+
+    return (w >= r) ? w - r : buffer.size() - r + w;
+  }
+
+  [[nodiscard]] auto write_available() const -> size_t { return capacity() - read_available(); }
+
+  // Returns how many elements were written. Anything that does not fit is dropped.
+
+  auto push(std::span<const T> data) -> size_t {
+    if (buffer.empty()) {
+      return 0U;
+    }
+
+    const auto n = std::min(data.size(), write_available());
+
+    auto w = write_index.load(std::memory_order_relaxed);
+
+    const auto n_first = std::min(n, buffer.size() - w);
+
+    std::copy_n(data.begin(), n_first, buffer.begin() + w);
+    std::copy_n(data.begin() + n_first, n - n_first, buffer.begin());
+
+    w = (w + n) % buffer.size();
+
+    write_index.store(w, std::memory_order_release);
+
+    return n;
+  }
+
+  // Returns how many elements were read into data
+
+  auto pop(std::span<T> data) -> size_t {
+    if (buffer.empty()) {
+      return 0U;
+    }
+
+    const auto n = std::min(data.size(), read_available());
+
+    auto r = read_index.load(std::memory_order_relaxed);
+
+    const auto n_first = std::min(n, buffer.size() - r);
+
+    std::copy_n(buffer.begin() + r, n_first, data.begin());
+    std::copy_n(buffer.begin(), n - n_first, data.begin() + n_first);
+
+    r = (r + n) % buffer.size();
+
+    read_index.store(r, std::memory_order_release);
+
+    return n;
+  }
+
+ private:
+  std::vector<T> buffer;
+
+  std::atomic<size_t> read_index = 0U;
+  std::atomic<size_t> write_index = 0U;
+};
+
+#endif
@@ -21,9 +21,13 @@
 #define RNNOISE_HPP
 
 #include <rnnoise.h>
-#include <deque>
+#include <chrono>
+#include "fork_join.hpp"
 #include "plugin_base.hpp"
 #include "resampler.hpp"
+#include "ring_buffer.hpp"
+#include "rnnoise_model_cache.hpp"
+#include "rnnoise_stereo_link.hpp"
 
 class RNNoise : public PluginBase {
  public:
@@ -47,6 +51,14 @@ class RNNoise : public PluginBase {
 
   float latency_value = 0.0F;
 
+  /*
+    stereo runs one network per channel. linked runs a single network on the mid channel and applies its band gains
+    to both channels. mono denoises the mid channel and sends it to both outputs. It is meant for mono microphones
+    whose signal is duplicated to both channels.
+  */
+
+  enum class ChannelMode { stereo, linked, mono };
+
  private:
   bool resample = false;
   bool notify_latency = false;
@@ -57,62 +69,132 @@ class RNNoise : public PluginBase {
   uint rnnoise_rate = 48000U;
   uint latency_n_frames = 0U;
 
+  ChannelMode channel_mode = ChannelMode::stereo;
+
+  // Used to report how much processing time the linked and mono modes save
+
+  static constexpr uint64_t report_interval = 1000U;  // rnnoise frames
+
+  uint64_t n_frames_saved = 0U;
+
+  double frame_time = 0.0;  // average in seconds of a rnnoise_process_frame call
+
   const float inv_short_max = 1.0F / (SHRT_MAX + 1);
 
-  std::deque<float> deque_out_L, deque_out_R;
+  // Sized in setup. The stereo mode writes to them from the ForkJoin helper, so they must not allocate.
+
+  RingBuffer<float> ring_out_L, ring_out_R;
 
-  std::vector<float> data_L, data_R;
+  std::vector<float> data_L, data_R, data_mid, denoised_mid;
   std::vector<float> resampled_data_L, resampled_data_R;
+  std::vector<float> mono_in;
+
+  // Buffers given to the resamplers. They are allocated in setup so that nothing is allocated in process.
+
+  std::vector<float> resampled_in_L, resampled_in_R;
+  std::vector<float> resampled_out_L, resampled_out_R;
 
   std::unique_ptr<Resampler> resampler_inL, resampler_outL;
   std::unique_ptr<Resampler> resampler_inR, resampler_outR;
 
-  RNNModel* model = nullptr;
+  RNNoiseModelCache::Model model;
 
   DenoiseState *state_left = nullptr, *state_right = nullptr;
 
-  auto get_model_from_file() -> RNNModel*;
+  std::unique_ptr<RNNoiseStereoLink> stereo_link;
+
+  auto get_model_from_file() -> RNNoiseModelCache::Model;
+
+  void load_model();
 
   void free_rnnoise();
 
+  void set_channel_mode();
+
+  void denoise_frame(DenoiseState* state, std::vector<float>& frame);
+
+  void denoise_linked_frame();
+
+  void report_savings();
+
+  static void append(std::vector<float>& out, const std::vector<float>& frame) {
+    out.insert(out.end(), frame.begin(), frame.end());
+  }
+
+  static void append(RingBuffer<float>& out, const std::vector<float>& frame) { out.push(frame); }
+
   template <typename T1, typename T2>
   void remove_noise(const T1& left_in, const T1& right_in, T2& out_L, T2& out_R) {
-    for (const auto& v : left_in) {
-      data_L.push_back(v);
+    if (channel_mode != ChannelMode::stereo) {
+      remove_noise_linked(left_in, right_in, out_L, out_R);
 
-      if (data_L.size() == blocksize) {
-        if (state_left != nullptr) {
-          std::ranges::for_each(data_L, [](auto& v) { v *= static_cast<float>(SHRT_MAX + 1); });
+      return;
+    }
 
-          rnnoise_process_frame(state_left, data_L.data(), data_L.data());
+    // the channels have their own networks and buffers, so they can be processed at the same time
 
-          std::ranges::for_each(data_L, [&](auto& v) { v *= inv_short_max; });
-        }
+    ForkJoin::get().run(
+        [&] {
+          for (const auto& v : left_in) {
+            data_L.push_back(v);
 
-        for (const auto& v : data_L) {
-          out_L.push_back(v);
-        }
+            if (data_L.size() == blocksize) {
+              denoise_frame(state_left, data_L);
 
-        data_L.resize(0);
-      }
-    }
+              append(out_L, data_L);
+
+              data_L.resize(0);
+            }
+          }
+        },
+        [&] {
+          for (const auto& v : right_in) {
+            data_R.push_back(v);
 
-    for (const auto& v : right_in) {
-      data_R.push_back(v);
+            if (data_R.size() == blocksize) {
+              denoise_frame(state_right, data_R);
 
-      if (data_R.size() == blocksize) {
-        if (state_right != nullptr) {
-          std::ranges::for_each(data_R, [](auto& v) { v *= static_cast<float>(SHRT_MAX + 1); });
+              append(out_R, data_R);
+
+              data_R.resize(0);
+            }
+          }
+        });
+  }
 
-          rnnoise_process_frame(state_right, data_R.data(), data_R.data());
+  // In the linked and mono modes both channels are handled together because they share a network
 
-          std::ranges::for_each(data_R, [&](auto& v) { v *= inv_short_max; });
+  template <typename T1, typename T2>
+  void remove_noise_linked(const T1& left_in, const T1& right_in, T2& out_L, T2& out_R) {
+    const auto size = std::min(left_in.size(), right_in.size());
+
+    for (size_t n = 0U; n < size; n++) {
+      data_L.push_back(left_in[n]);
+      data_R.push_back(right_in[n]);
+
+      if (data_L.size() == blocksize) {
+        if (channel_mode == ChannelMode::linked) {
+          denoise_linked_frame();
+        } else {
+          for (size_t m = 0U; m < blocksize; m++) {
+            data_L[m] = 0.5F * (data_L[m] + data_R[m]);
+          }
+
+          denoise_frame(state_left, data_L);
+
+          std::copy(data_L.begin(), data_L.end(), data_R.begin());
         }
 
-        for (const auto& v : data_R) {
-          out_R.push_back(v);
+        n_frames_saved++;
+
+        if (n_frames_saved % report_interval == 0U) {
+          report_savings();
         }
 
+        append(out_L, data_L);
+        append(out_R, data_R);
+
+        data_L.resize(0);
         data_R.resize(0);
       }
     }
@@ -0,0 +1,63 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RNNOISE_MODEL_CACHE_HPP
+#define RNNOISE_MODEL_CACHE_HPP
+
+#include <rnnoise.h>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "util.hpp"
+
+/*
+  Models loaded from files are shared by every RNNoise instance that uses the same file. The denoise states only read
+  the model weights, so one copy is enough for the input and output pipelines. A model is freed when the last state
+  that uses it is gone.
+*/
+
+class RNNoiseModelCache {
+ public:
+  RNNoiseModelCache(const RNNoiseModelCache&) = delete;
+  auto operator=(const RNNoiseModelCache&) -> RNNoiseModelCache& = delete;
+  RNNoiseModelCache(const RNNoiseModelCache&&) = delete;
+  auto operator=(const RNNoiseModelCache&&) -> RNNoiseModelCache& = delete;
+
+  using Model = std::shared_ptr<RNNModel>;
+
+  static auto get() -> RNNoiseModelCache&;
+
+  // nullptr is returned when the file can not be loaded. In this case rnnoise uses its default model.
+
+  auto get_model(const std::string& path) -> Model;
+
+ private:
+  RNNoiseModelCache() = default;
+  ~RNNoiseModelCache() = default;
+
+  const std::string log_tag = "rnnoise_model_cache: ";
+
+  std::map<std::string, std::weak_ptr<RNNModel>> models;
+
+  std::mutex models_mutex;
+};
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RNNOISE_STEREO_LINK_HPP
+#define RNNOISE_STEREO_LINK_HPP
+
+#include <fftw3.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <vector>
+
+/*
+  Applies the noise suppression that rnnoise did on the mid channel to the left and right channels. rnnoise does not
+  expose the gains of its bands, so they are estimated from the energy of the mid channel before and after it went
+  through the network. The bands and the analysis window are the same rnnoise uses. The gains are then applied to
+  the spectrum of each channel with the usual overlap-add.
+
+  rnnoise delays its output by one frame and the overlap-add adds another one, so the channels are delayed by two
+  frames in total.
+*/
+
+class RNNoiseStereoLink {
+ public:
+  RNNoiseStereoLink();
+  RNNoiseStereoLink(const RNNoiseStereoLink&) = delete;
+  auto operator=(const RNNoiseStereoLink&) -> RNNoiseStereoLink& = delete;
+  RNNoiseStereoLink(const RNNoiseStereoLink&&) = delete;
+  auto operator=(const RNNoiseStereoLink&&) -> RNNoiseStereoLink& = delete;
+  ~RNNoiseStereoLink();
+
+  static constexpr uint frame_size = 480U;
+
+  void reset();
+
+  /*
+    mid_in is the mid channel given to rnnoise in this frame and mid_out is what rnnoise returned for it. The output
+    replaces the left and right frames.
+  */
+
+  void process(std::span<float> left,
+               std::span<float> right,
+               std::span<const float> mid_in,
+               std::span<const float> mid_out);
+
+ private:
+  static constexpr uint window_size = 2U * frame_size;
+  static constexpr uint n_bins = frame_size + 1U;
+  static constexpr uint n_bands = 22U;
+
+  // rnnoise band edges in units of 200 Hz
+
+  static constexpr std::array<uint, n_bands> band_edges = {0,  1,  2,  3,  4,  5,  6,  7,  8,  10, 12,
+                                                           14, 16, 20, 24, 28, 34, 40, 48, 60, 78, 100};
+
+  static constexpr uint bins_per_edge = 4U;  // 200 Hz / 50 Hz
+
+  std::vector<float> window;
+
+  std::vector<float> mid_delay, mid_in_history, mid_out_history;
+
+  std::vector<float> delay_L, delay_R, history_L, history_R, overlap_L, overlap_R;
+
+  std::array<float, n_bands> band_energy_in{}, band_energy_out{}, band_gains{};
+
+  std::vector<float> bin_gains;
+
+  float* time_data = nullptr;
+
+  fftwf_complex* spectrum = nullptr;
+
+  fftwf_plan forward_plan = nullptr;
+  fftwf_plan backward_plan = nullptr;
+
+  void analyze(const std::vector<float>& history, std::array<float, n_bands>& band_energy);
+
+  void apply_gains(std::span<float> data,
+                   std::vector<float>& delay,
+                   std::vector<float>& history,
+                   std::vector<float>& overlap);
+
+  static void push_frame(std::vector<float>& history, std::span<const float> frame) {
+    std::copy(history.begin() + frame_size, history.end(), history.begin());
+    std::copy(frame.begin(), frame.end(), history.end() - frame_size);
+  }
+};
+
+#endif
@@ -20,9 +20,8 @@
 #ifndef SPECTRUM_HPP
 #define SPECTRUM_HPP
 
-#include <fftw3.h>
-#include <numbers>
 #include "plugin_base.hpp"
+#include "spectrum_analyzer.hpp"
 
 class Spectrum : public PluginBase {
  public:
@@ -36,6 +35,8 @@ class Spectrum : public PluginBase {
   auto operator=(const Spectrum&&) -> Spectrum& = delete;
   ~Spectrum() override;
 
+  using Frame = SpectrumAnalyzer::Frame;
+
   void setup() override;
 
   void process(std::span<float>& left_in,
@@ -45,20 +46,14 @@ class Spectrum : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
-  sigc::signal<void(uint, uint, std::vector<float>)> power;  // rate, nbands, magnitudes
-
- private:
-  bool fftw_ready = false;
-
-  fftwf_plan plan = nullptr;
-
-  fftwf_complex* complex_output = nullptr;
+  // Swaps the newest frame into frame. Returns false if nothing was published since the last call.
 
-  std::vector<float> real_input, output;
+  auto get_frame(Frame& frame) -> bool;
 
-  uint n_bands = 4096U, total_count = 0U;
+ private:
+  // The analysis itself is done by the shared SpectrumAnalyzer
 
-  float fft_buffer_duration = 0.0F;
+  std::shared_ptr<SpectrumAnalyzer::Tap> tap;
 };
 
 #endif
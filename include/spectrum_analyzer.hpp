@@ -0,0 +1,233 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPECTRUM_ANALYZER_HPP
+#define SPECTRUM_ANALYZER_HPP
+
+#include <fftw3.h>
+#include <gio/gio.h>
+#include <pthread.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <numbers>
+#include <numeric>
+#include <span>
+#include <thread>
+#include <vector>
+#include "app_tags.hpp"
+#include "ring_buffer.hpp"
+#include "util.hpp"
+
+/*
+  One analyzer shared by every spectrum in the application. Audio enters through taps. The spectrum node at the end
+  of each pipeline owns one, and every plugin has a tap before and one after its processing. A single low priority
+  thread runs the overlapping windowed transforms for all taps with the same fftw plan, bins them on the log spaced
+  frequency axis and publishes frames in dB.
+
+  A tap only costs something while somebody is subscribed to it. Without subscribers the realtime thread does not
+  even copy its samples.
+
+  In multi-resolution mode three transforms of the same size class cover different frequency regions. The bass is
+  read from a 4096 points transform of the signal decimated by 4, which is a window four times longer than the
+  default one. The mids use the default transform and the treble a short 1024 points transform that follows fast
+  changes. This costs a bit more than twice the single transform instead of the sixteen times a 16384 points
+  transform would need for the same bass resolution.
+*/
+
+class SpectrumAnalyzer {
+ public:
+  SpectrumAnalyzer(const SpectrumAnalyzer&) = delete;
+  auto operator=(const SpectrumAnalyzer&) -> SpectrumAnalyzer& = delete;
+  SpectrumAnalyzer(const SpectrumAnalyzer&&) = delete;
+  auto operator=(const SpectrumAnalyzer&&) -> SpectrumAnalyzer& = delete;
+
+  /*
+    A frame ready to be drawn: the log spaced frequencies and their levels in dB. axis_serial changes whenever the
+    frequencies change, so the UI only has to update the x axis of its chart when it sees a new serial.
+  */
+
+  struct Frame {
+    std::vector<float> frequencies;
+    std::vector<float> magnitudes;
+
+    uint axis_serial = 0U;
+  };
+
+  enum class Resolution : uint8_t { bass, mid, treble };
+
+  class Tap {
+   public:
+    // Called by the realtime thread whenever the sampling rate or the quantum changes
+
+    void set_rate(const uint& sampling_rate, const uint& n_samples);
+
+    void push(std::span<const float> left, std::span<const float> right);
+
+    // Swaps the newest frame into frame. Returns false if nothing was published since the last call.
+
+    auto get_frame(Frame& frame) -> bool;
+
+    [[nodiscard]] auto is_subscribed() const -> bool { return n_subscribers.load(std::memory_order_acquire) > 0; }
+
+   private:
+    friend class SpectrumAnalyzer;
+
+    bool new_frame = false;
+
+    std::atomic<int> n_subscribers = 0;
+
+    std::atomic<bool> reset_requested = false;  // set by subscribe(), handled by the analyzer thread
+
+    std::atomic<uint> rate = 0U;
+
+    uint bins_rate = 0U;
+    uint bins_serial = 0U;
+
+    std::vector<float> downmix;  // realtime thread only
+
+    RingBuffer<float> ring;
+
+    std::vector<float> history, hop_buffer, peaks;
+
+    // Multi-resolution mode: the signal decimated for the bass transform and the input the decimation filter needs
+
+    uint decimation_phase = 0U;
+
+    std::vector<float> decimated_history, decimator_input;
+
+    // Range of fft bins summed into each point of the frame and the transform they come from
+
+    std::vector<uint> bin_first, bin_last;
+
+    std::vector<Resolution> bin_source;
+
+    // The analyzer fills back_frame and swaps it with ready_frame. The UI swaps ready_frame with its own copy.
+
+    Frame back_frame, ready_frame;
+
+    std::mutex frame_mutex;
+  };
+
+  static auto get() -> SpectrumAnalyzer&;
+
+  // The next functions are meant for the main thread
+
+  [[nodiscard]] static auto create_tap() -> std::shared_ptr<Tap>;
+
+  void subscribe(const std::shared_ptr<Tap>& tap);
+
+  void unsubscribe(const std::shared_ptr<Tap>& tap);
+
+  static constexpr uint n_bands = 4096U;
+
+  static constexpr uint n_short_bands = 1024U;
+
+  static constexpr uint decimation = 4U;
+
+ private:
+  SpectrumAnalyzer();
+  ~SpectrumAnalyzer();
+
+  const std::string log_tag = "spectrum_analyzer: ";
+
+  static constexpr float display_rate = 20.0F;  // frames per second
+
+  bool quit = false;
+
+  uint n_points = 100U;
+
+  float minimum_frequency = 20.0F;
+  float maximum_frequency = 20000.0F;
+
+  /*
+    The settings the analysis depends on. The main thread changes config while holding analyzer_mutex. The analyzer
+    thread copies it to active_config when serial changes and then analyzes the taps without holding the lock.
+  */
+
+  struct Config {
+    bool peak_hold = false;
+    bool multi_resolution = false;
+
+    uint serial = 0U;
+    uint axis_serial = 0U;
+    uint bins_serial = 0U;  // changes when the axis or the resolution mode change
+
+    float peak_decay = 20.0F;  // dB per second
+
+    std::vector<float> axis;
+  };
+
+  Config config, active_config;
+
+  // Frequencies where the multi-resolution mode switches from the bass to the mid and from the mid to the treble
+  // transform
+
+  static constexpr float bass_crossover = 250.0F;
+  static constexpr float treble_crossover = 2500.0F;
+
+  GSettings* settings = nullptr;
+
+  std::vector<float> window, real_input, output;
+
+  std::vector<float> short_window, short_input, bass_output, treble_output;
+
+  std::vector<float> decimation_filter;
+
+  std::vector<std::weak_ptr<Tap>> taps;
+
+  std::vector<std::shared_ptr<Tap>> active_taps;  // analyzer thread only
+
+  fftwf_complex* complex_output = nullptr;
+  fftwf_complex* short_complex_output = nullptr;
+
+  fftwf_plan plan = nullptr;
+  fftwf_plan short_plan = nullptr;
+
+  std::thread worker;
+
+  std::mutex analyzer_mutex;
+
+  std::condition_variable analyzer_cv;
+
+  void work();
+
+  auto analyze(Tap& tap) -> bool;
+
+  void decimate(Tap& tap, std::span<const float> hop);
+
+  void power_spectrum(std::span<const float> input,
+                      const std::vector<float>& window_table,
+                      std::vector<float>& input_buffer,
+                      fftwf_plan& fft_plan,
+                      fftwf_complex* fft_output,
+                      std::vector<float>& power);
+
+  void update_bins(Tap& tap, const uint& sampling_rate);
+
+  void bin_frame(Tap& tap, const float& hop_seconds);
+
+  void read_axis_settings();
+};
+
+#endif
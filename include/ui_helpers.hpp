@@ -23,13 +23,17 @@
 #include <fmt/core.h>
 #include <fmt/format.h>
 #include <algorithm>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 #include "app_tags.hpp"
 #include "string_literal_wrapper.hpp"
 #include "util.hpp"
 
+class PluginBase;
+
 namespace ui {
 
 auto parse_spinbutton_output(GtkSpinButton* button, const char* unit) -> bool;
@@ -43,6 +47,26 @@ void update_level(GtkLevelBar* w_left,
                   const float& left,
                   const float& right);
 
+/*
+  Calls callback once per frame of the widget's frame clock. The tick callback is only installed while the widget is
+  mapped, so hidden pages and closed windows do no work at all.
+*/
+
+void add_tick_callback(GtkWidget* widget, std::function<void()> callback);
+
+// Refreshes the input and output level meters of a plugin box from the frame clock whenever the plugin has new levels
+
+void add_level_meters_tick(GtkWidget* widget,
+                           std::shared_ptr<PluginBase> plugin,
+                           GtkLevelBar* input_left,
+                           GtkLabel* input_left_label,
+                           GtkLevelBar* input_right,
+                           GtkLabel* input_right_label,
+                           GtkLevelBar* output_left,
+                           GtkLabel* output_left_label,
+                           GtkLevelBar* output_right,
+                           GtkLabel* output_right_label);
+
 void append_to_string_list(GtkStringList* string_list, const std::string& name);
 
 void remove_from_string_list(GtkStringList* string_list, const std::string& name);
@@ -76,6 +76,10 @@ auto remove_filename_extension(const std::string& basename) -> std::string;
 
 void print_thread_id();
 
+// Priority of the calling thread if it runs with SCHED_FIFO or SCHED_RR. Otherwise 0.
+
+auto get_realtime_priority() -> int;
+
 auto gchar_array_to_vector(gchar** gchar_array, const bool free_data = true) -> std::vector<std::string>;
 
 auto make_gchar_pointer_vector(const std::vector<std::string>& input) -> std::vector<const gchar*>;
@@ -96,6 +100,16 @@ auto get_files_name(std::filesystem::path dir_path, const std::string& ext) -> s
 
 void reset_all_keys(GSettings* settings);
 
+// Tells the cpu that we are in a spin loop. It saves power and lets the other hyperthread of the core run.
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
 template <typename T>
 void print_type(T v) {
   warning(typeid(v).name());
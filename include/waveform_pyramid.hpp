@@ -0,0 +1,57 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef WAVEFORM_PYRAMID_HPP
+#define WAVEFORM_PYRAMID_HPP
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+/*
+  Min/max decimation pyramid of a long signal. Level k keeps the minimum and the maximum of every block of 2^k
+  samples, so each level has half the entries of the one below it. Building it is a single pass over the signal
+  and should happen off the main thread.
+
+  Plotting asks for a number of columns, usually the width in pixels, and gets two points per column read from the
+  level whose blocks are just smaller than a column. The cost depends on the number of columns and not on the length
+  of the signal. As minima and maxima survive every level the peaks are never lost, whatever the zoom.
+*/
+
+class WaveformPyramid {
+ public:
+  void build(std::span<const float> signal, const float& sample_period);
+
+  // Fills x (in the units of sample_period) and y with two points per column
+
+  void query(const uint& n_columns, std::vector<float>& x, std::vector<float>& y) const;
+
+  [[nodiscard]] auto size() const -> size_t { return samples.size(); }
+
+ private:
+  float dt = 0.0F;
+
+  std::vector<float> samples;
+
+  // level_min[k] and level_max[k] hold blocks of 2^(k + 1) samples
+
+  std::vector<std::vector<float>> level_min, level_max;
+};
+
+#endif
@@ -74,6 +74,13 @@ void on_startup(GApplication* gapp) {
 
   PipeManager::exclude_monitor_stream = g_settings_get_boolean(self->settings, "exclude-monitor-streams") != 0;
 
+  ConvolverWorkerPool::get().set_n_threads(
+      static_cast<uint>(g_settings_get_int(self->settings, "convolver-threads")));
+
+  ConvolverWorkerPool::get().set_priority(g_settings_get_int(self->settings, "convolver-thread-priority"));
+
+  ForkJoin::get().set_enabled(g_settings_get_boolean(self->settings, "process-channels-in-parallel") != 0);
+
   if (g_settings_get_boolean(self->settings, "reset-volume-on-startup") != 0) {
     PipeManager::set_node_mute(self->pm->ee_source_node.proxy, false);
     PipeManager::set_node_volume(self->pm->ee_source_node.proxy, self->pm->ee_source_node.n_volume_channels, 1.0);
@@ -225,6 +232,27 @@ void on_startup(GApplication* gapp) {
                        }),
                        self));
 
+  self->data->gconnections.push_back(
+      g_signal_connect(self->settings, "changed::convolver-threads",
+                       G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                         ConvolverWorkerPool::get().set_n_threads(static_cast<uint>(g_settings_get_int(settings, key)));
+                       }),
+                       self));
+
+  self->data->gconnections.push_back(
+      g_signal_connect(self->settings, "changed::convolver-thread-priority",
+                       G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                         ConvolverWorkerPool::get().set_priority(g_settings_get_int(settings, key));
+                       }),
+                       self));
+
+  self->data->gconnections.push_back(
+      g_signal_connect(self->settings, "changed::process-channels-in-parallel",
+                       G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                         ForkJoin::get().set_enabled(g_settings_get_boolean(settings, key) != 0);
+                       }),
+                       self));
+
   update_bypass_state(self);
 
   if ((g_application_get_flags(gapp) & G_APPLICATION_IS_SERVICE) != 0) {
@@ -28,6 +28,8 @@ AutoGain::AutoGain(const std::string& tag,
 
   reference = parse_reference_key(util::gsettings_get_string(settings, "reference"));
 
+  maximum_history = g_settings_get_int(settings, "maximum-history");
+
   gconnections.push_back(g_signal_connect(settings, "changed::target",
                                           G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
                                             auto self = static_cast<AutoGain*>(user_data);
@@ -40,9 +42,7 @@ AutoGain::AutoGain(const std::string& tag,
                                           G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
                                             auto self = static_cast<AutoGain*>(user_data);
 
-                                            std::scoped_lock<std::mutex> lock(self->data_mutex);
-
-                                            self->set_maximum_history(g_settings_get_int(settings, key));
+                                            self->maximum_history = g_settings_get_int(settings, key);
                                           }),
                                           this));
 
@@ -50,21 +50,7 @@ AutoGain::AutoGain(const std::string& tag,
       settings, "changed::reset-history", G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
         auto self = static_cast<AutoGain*>(user_data);
 
-        self->mythreads.emplace_back([self]() {  // Using emplace_back here makes sense
-          self->data_mutex.lock();
-
-          self->ebur128_ready = false;
-
-          self->data_mutex.unlock();
-
-          auto status = self->init_ebur128();
-
-          self->data_mutex.lock();
-
-          self->ebur128_ready = status;
-
-          self->data_mutex.unlock();
-        });
+        self->reset_history = true;
       }),
       this));
 
@@ -77,6 +63,8 @@ AutoGain::AutoGain(const std::string& tag,
       this));
 
   setup_input_output_gain();
+
+  worker = std::thread([this]() { work(); });
 }
 
 AutoGain::~AutoGain() {
@@ -84,42 +72,94 @@ AutoGain::~AutoGain() {
     disconnect_from_pw();
   }
 
-  for (auto& t : mythreads) {
-    t.join();
+  {
+    std::scoped_lock<std::mutex> lock(worker_mutex);
+
+    worker_quit = true;
   }
 
-  mythreads.clear();
+  worker_cv.notify_one();
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  if (worker.joinable()) {
+    worker.join();
+  }
 
-  if (ebur_state != nullptr) {
-    ebur128_destroy(&ebur_state);
+  for (auto& state : ebur_states) {
+    if (state != nullptr) {
+      ebur128_destroy(&state);
+    }
   }
 
   util::debug(log_tag + name + " destroyed");
 }
 
-auto AutoGain::init_ebur128() -> bool {
-  if (n_samples == 0 || rate == 0) {
-    return false;
+auto AutoGain::create_ebur128_state(const uint& sampling_rate) -> ebur128_state* {
+  /*
+    In histogram mode the integrated loudness and the loudness range are read from fixed size histograms instead of
+    scanning every gating block kept in the history.
+  */
+
+  auto* state = ebur128_init(
+      2U, sampling_rate,
+      EBUR128_MODE_S | EBUR128_MODE_I | EBUR128_MODE_LRA | EBUR128_MODE_SAMPLE_PEAK | EBUR128_MODE_HISTOGRAM);
+
+  if (state != nullptr) {
+    ebur128_set_channel(state, 0U, EBUR128_LEFT);
+    ebur128_set_channel(state, 1U, EBUR128_RIGHT);
   }
 
-  if (ebur_state != nullptr) {
-    ebur128_destroy(&ebur_state);
+  return state;
+}
 
-    ebur_state = nullptr;
+auto AutoGain::init_ebur128(const uint& sampling_rate) -> bool {
+  if (sampling_rate == 0) {
+    return false;
+  }
+
+  for (auto& state : ebur_states) {
+    if (state != nullptr) {
+      ebur128_destroy(&state);
+    }
   }
 
-  ebur_state = ebur128_init(2U, rate, EBUR128_MODE_S | EBUR128_MODE_I | EBUR128_MODE_LRA | EBUR128_MODE_SAMPLE_PEAK);
+  n_frames_fed = {0U, 0U};
 
-  ebur128_set_channel(ebur_state, 0U, EBUR128_LEFT);
-  ebur128_set_channel(ebur_state, 1U, EBUR128_RIGHT);
+  applied_history = maximum_history.load();
 
-  set_maximum_history(g_settings_get_int(settings, "maximum-history"));
+  // The second state is only created when the first one is half a window old
+
+  ebur_states[0] = create_ebur128_state(sampling_rate);
+
+  ebur_state = ebur_states[0];
 
   return ebur_state != nullptr;
 }
 
+void AutoGain::rotate_ebur128_states(const uint& sampling_rate) {
+  const auto window = static_cast<uint64_t>(applied_history) * sampling_rate;
+
+  const uint older = (n_frames_fed[0] >= n_frames_fed[1]) ? 0U : 1U;
+  const uint younger = 1U - older;
+
+  if (ebur_states[younger] == nullptr && n_frames_fed[older] >= window / 2U) {
+    ebur_states[younger] = create_ebur128_state(sampling_rate);
+
+    n_frames_fed[younger] = 0U;
+  }
+
+  if (n_frames_fed[older] >= window && ebur_states[younger] != nullptr) {
+    if (ebur_states[older] != nullptr) {
+      ebur128_destroy(&ebur_states[older]);
+    }
+
+    ebur_states[older] = create_ebur128_state(sampling_rate);
+
+    n_frames_fed[older] = 0U;
+  }
+
+  ebur_state = ebur_states[(n_frames_fed[0] >= n_frames_fed[1]) ? 0U : 1U];
+}
+
 auto AutoGain::parse_reference_key(const std::string& key) -> Reference {
   if (key == "Momentary") {
     return Reference::momentary;
@@ -148,45 +188,21 @@ auto AutoGain::parse_reference_key(const std::string& key) -> Reference {
   return Reference::geometric_mean_msi;
 }
 
-void AutoGain::set_maximum_history(const int& seconds) {
-  if (ebur_state == nullptr) {
-    return;
-  }
-
-  // The value given to ebur128_set_max_history must be in milliseconds
-
-  ebur128_set_max_history(ebur_state, static_cast<ulong>(seconds) * 1000ul);
-}
-
 void AutoGain::setup() {
   if (2 * n_samples != data.size()) {
     data.resize(n_samples * 2);
   }
 
-  if (rate != old_rate) {
-    data_mutex.lock();
-
-    ebur128_ready = false;
-
-    data_mutex.unlock();
-
-    mythreads.emplace_back([this]() {  // Using emplace_back here makes sense
-      if (ebur128_ready) {
-        return;
-      }
-
-      auto status = true;
-
-      old_rate = rate;
+  gain_smoothing = 1.0 - std::exp(-static_cast<double>(buffer_duration) / gain_time_constant);
 
-      status = init_ebur128();
+  if (rate != old_rate) {
+    old_rate = rate;
 
-      data_mutex.lock();
+    // The worker resizes the ring and rebuilds the ebur128 state. Until then process() leaves the ring alone.
 
-      ebur128_ready = status;
+    ebur128_rate.store(rate, std::memory_order_relaxed);
 
-      data_mutex.unlock();
-    });
+    rate_changed.store(true, std::memory_order_release);
   }
 }
 
@@ -196,7 +212,7 @@ void AutoGain::process(std::span<float>& left_in,
                        std::span<float>& right_out) {
   std::scoped_lock<std::mutex> lock(data_mutex);
 
-  if (bypass || !ebur128_ready) {
+  if (bypass) {
     std::copy(left_in.begin(), left_in.end(), left_out.begin());
     std::copy(right_in.begin(), right_in.end(), right_out.begin());
 
@@ -212,115 +228,28 @@ void AutoGain::process(std::span<float>& left_in,
     data[2U * n + 1U] = right_in[n];
   }
 
-  ebur128_add_frames_float(ebur_state, data.data(), n_samples);
-
-  auto failed = false;
-
-  if (EBUR128_SUCCESS != ebur128_loudness_momentary(ebur_state, &momentary)) {
-    failed = true;
-  }
-
-  if (EBUR128_SUCCESS != ebur128_loudness_shortterm(ebur_state, &shortterm)) {
-    failed = true;
-  }
-
-  if (EBUR128_SUCCESS != ebur128_loudness_global(ebur_state, &global)) {
-    failed = true;
-  }
-
-  if (EBUR128_SUCCESS != ebur128_relative_threshold(ebur_state, &relative)) {
-    failed = true;
-  }
+  // If the worker fell behind the block is dropped as a whole so that the channels stay interleaved
 
-  if (EBUR128_SUCCESS != ebur128_loudness_range(ebur_state, &range)) {
-    failed = true;
+  if (!rate_changed.load(std::memory_order_acquire) && ring.write_available() >= data.size()) {
+    ring.push(data);
   }
 
-  if (relative > -70.0F && momentary > -70.0F && !failed) {
-    double peak_L = 0.0;
-    double peak_R = 0.0;
-
-    if (EBUR128_SUCCESS != ebur128_prev_sample_peak(ebur_state, 0U, &peak_L)) {
-      failed = true;
-    }
-
-    if (EBUR128_SUCCESS != ebur128_prev_sample_peak(ebur_state, 1U, &peak_R)) {
-      failed = true;
-    }
+  /*
+    The worker only updates the target every 100 ms. The gain follows it with a one pole smoother and is ramped
+    linearly inside the block so that the steps are not audible.
+  */
 
-    if (!failed) {
-      switch (reference) {
-        case Reference::momentary: {
-          loudness = momentary;
-
-          break;
-        }
-        case Reference::shortterm: {
-          loudness = shortterm;
-
-          break;
-        }
-        case Reference::integrated: {
-          loudness = global;
-
-          break;
-        }
-        case Reference::geometric_mean_msi: {
-          loudness = std::cbrt(momentary * shortterm * global);
-
-          break;
-        }
-        case Reference::geometric_mean_ms: {
-          loudness = std::sqrt(std::fabs(momentary * shortterm));
-
-          if (momentary < 0 && shortterm < 0) {
-            loudness *= -1;
-          }
-
-          break;
-        }
-        case Reference::geometric_mean_mi: {
-          loudness = std::sqrt(std::fabs(momentary * global));
-
-          if (momentary < 0 && global < 0) {
-            loudness *= -1;
-          }
-
-          break;
-        }
-        case Reference::geometric_mean_si: {
-          loudness = std::sqrt(std::fabs(shortterm * global));
-
-          if (shortterm < 0 && global < 0) {
-            loudness *= -1;
-          }
-
-          break;
-        }
-      }
+  const double old_gain = internal_output_gain;
 
-      const double diff = target - loudness;
+  internal_output_gain += (target_gain.load(std::memory_order_relaxed) - old_gain) * gain_smoothing;
 
-      // 10^(diff/20). The way below should be faster than using pow
-      const double gain = std::exp((diff / 20.0) * std::log(10.0));
+  const double delta = (internal_output_gain - old_gain) / static_cast<double>(n_samples);
 
-      const double peak = (peak_L > peak_R) ? peak_L : peak_R;
-
-      const auto db_peak = util::linear_to_db(peak);
-
-      if (db_peak > util::minimum_db_level) {
-        if (gain * peak < 1.0) {
-          internal_output_gain = gain;
-        }
-      }
-    }
-  }
-
-  std::copy(left_in.begin(), left_in.end(), left_out.begin());
-  std::copy(right_in.begin(), right_in.end(), right_out.begin());
+  for (uint n = 0U; n < n_samples; n++) {
+    const auto g = static_cast<float>(old_gain + delta * static_cast<double>(n + 1U));
 
-  if (internal_output_gain != 1.0F) {
-    apply_gain(left_out, right_out, static_cast<float>(internal_output_gain));
+    left_out[n] = left_in[n] * g;
+    right_out[n] = right_in[n] * g;
   }
 
   if (output_gain != 1.0F) {
@@ -345,8 +274,9 @@ void AutoGain::process(std::span<float>& left_in,
                          return G_SOURCE_REMOVE;
                        }
 
-                       self->results.emit(self->loudness, self->internal_output_gain, self->momentary, self->shortterm,
-                                          self->global, self->relative, self->range);
+                       self->results.emit(self->loudness.load(), self->internal_output_gain, self->momentary.load(),
+                                          self->shortterm.load(), self->global.load(), self->relative.load(),
+                                          self->range.load());
 
                        return G_SOURCE_REMOVE;
                      },
@@ -359,6 +289,191 @@ void AutoGain::process(std::span<float>& left_in,
   }
 }
 
+void AutoGain::work() {
+  while (true) {
+    // The mutex only protects the wait. Nothing else in this loop holds it.
+
+    {
+      std::unique_lock<std::mutex> lock(worker_mutex);
+
+      worker_cv.wait_for(lock, worker_period, [this]() { return worker_quit; });
+
+      if (worker_quit) {
+        break;
+      }
+    }
+
+    if (rate_changed.load(std::memory_order_acquire)) {
+      /*
+        The worker drains the ring every 100 ms. One second of audio leaves plenty of room for scheduling hiccups.
+        The realtime thread does not touch the ring while rate_changed is set.
+      */
+
+      const auto new_rate = ebur128_rate.load(std::memory_order_relaxed);
+
+      ring.resize(2U * static_cast<size_t>(new_rate));
+
+      worker_data.resize(ring.capacity());
+
+      ebur128_ready = false;
+
+      rate_changed.store(false, std::memory_order_release);
+    }
+
+    const auto sampling_rate = ebur128_rate.load(std::memory_order_relaxed);
+
+    // A new window length restarts the measurement like a reset does
+
+    if (reset_history.exchange(false) || maximum_history.load() != applied_history ||
+        (!ebur128_ready && sampling_rate != 0U)) {
+      ebur128_ready = init_ebur128(sampling_rate);
+    }
+
+    const auto n_read = ring.pop(worker_data);
+
+    if (!ebur128_ready || n_read < 2U) {
+      continue;
+    }
+
+    for (size_t n = 0U; n < ebur_states.size(); n++) {
+      if (ebur_states[n] != nullptr) {
+        ebur128_add_frames_float(ebur_states[n], worker_data.data(), n_read / 2U);
+
+        n_frames_fed[n] += n_read / 2U;
+      }
+    }
+
+    rotate_ebur128_states(sampling_rate);
+
+    if (ebur_state != nullptr) {
+      update_target_gain();
+    }
+  }
+}
+
+void AutoGain::update_target_gain() {
+  auto failed = false;
+
+  double momentary_value = 0.0;
+  double shortterm_value = 0.0;
+  double global_value = 0.0;
+  double relative_value = 0.0;
+  double range_value = 0.0;
+  double loudness_value = 0.0;
+
+  if (EBUR128_SUCCESS != ebur128_loudness_momentary(ebur_state, &momentary_value)) {
+    failed = true;
+  }
+
+  if (EBUR128_SUCCESS != ebur128_loudness_shortterm(ebur_state, &shortterm_value)) {
+    failed = true;
+  }
+
+  if (EBUR128_SUCCESS != ebur128_loudness_global(ebur_state, &global_value)) {
+    failed = true;
+  }
+
+  if (EBUR128_SUCCESS != ebur128_relative_threshold(ebur_state, &relative_value)) {
+    failed = true;
+  }
+
+  if (EBUR128_SUCCESS != ebur128_loudness_range(ebur_state, &range_value)) {
+    failed = true;
+  }
+
+  if (failed) {
+    return;
+  }
+
+  momentary = momentary_value;
+  shortterm = shortterm_value;
+  global = global_value;
+  relative = relative_value;
+  range = range_value;
+
+  if (relative_value <= -70.0F || momentary_value <= -70.0F) {
+    return;
+  }
+
+  double peak_L = 0.0;
+  double peak_R = 0.0;
+
+  if (EBUR128_SUCCESS != ebur128_prev_sample_peak(ebur_state, 0U, &peak_L)) {
+    return;
+  }
+
+  if (EBUR128_SUCCESS != ebur128_prev_sample_peak(ebur_state, 1U, &peak_R)) {
+    return;
+  }
+
+  switch (reference) {
+    case Reference::momentary: {
+      loudness_value = momentary_value;
+
+      break;
+    }
+    case Reference::shortterm: {
+      loudness_value = shortterm_value;
+
+      break;
+    }
+    case Reference::integrated: {
+      loudness_value = global_value;
+
+      break;
+    }
+    case Reference::geometric_mean_msi: {
+      loudness_value = std::cbrt(momentary_value * shortterm_value * global_value);
+
+      break;
+    }
+    case Reference::geometric_mean_ms: {
+      loudness_value = std::sqrt(std::fabs(momentary_value * shortterm_value));
+
+      if (momentary_value < 0 && shortterm_value < 0) {
+        loudness_value *= -1;
+      }
+
+      break;
+    }
+    case Reference::geometric_mean_mi: {
+      loudness_value = std::sqrt(std::fabs(momentary_value * global_value));
+
+      if (momentary_value < 0 && global_value < 0) {
+        loudness_value *= -1;
+      }
+
+      break;
+    }
+    case Reference::geometric_mean_si: {
+      loudness_value = std::sqrt(std::fabs(shortterm_value * global_value));
+
+      if (shortterm_value < 0 && global_value < 0) {
+        loudness_value *= -1;
+      }
+
+      break;
+    }
+  }
+
+  loudness = loudness_value;
+
+  const double diff = target - loudness_value;
+
+  // 10^(diff/20). The way below should be faster than using pow
+  const double gain = std::exp((diff / 20.0) * std::log(10.0));
+
+  const double peak = (peak_L > peak_R) ? peak_L : peak_R;
+
+  const auto db_peak = util::linear_to_db(peak);
+
+  if (db_peak > util::minimum_db_level) {
+    if (gain * peak < 1.0) {
+      target_gain.store(gain, std::memory_order_relaxed);
+    }
+  }
+}
+
 auto AutoGain::get_latency_seconds() -> float {
   return 0.0F;
 }
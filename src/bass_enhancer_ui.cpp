@@ -82,15 +82,9 @@ void setup(BassEnhancerBox* self, std::shared_ptr<BassEnhancer> bass_enhancer, c
   bass_enhancer->post_messages = true;
   bass_enhancer->bypass = false;
 
-  self->data->connections.push_back(bass_enhancer->input_level.connect([=](const float& left, const float& right) {
-    update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                 self->input_level_right_label, left, right);
-  }));
-
-  self->data->connections.push_back(bass_enhancer->output_level.connect([=](const float& left, const float& right) {
-    update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                 self->output_level_right_label, left, right);
-  }));
+  add_level_meters_tick(GTK_WIDGET(self), bass_enhancer, self->input_level_left, self->input_level_left_label,
+                        self->input_level_right, self->input_level_right_label, self->output_level_left,
+                        self->output_level_left_label, self->output_level_right, self->output_level_right_label);
 
   self->data->connections.push_back(bass_enhancer->harmonics.connect([=](const double& value) {
     gtk_level_bar_set_value(self->harmonics_levelbar, value);
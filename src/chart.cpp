@@ -25,14 +25,26 @@ using namespace std::string_literals;
 
 auto constexpr log_tag = "chart_box: ";
 
+constexpr uint frame_time_report_interval = 600U;  // about 10 seconds at 60 fps
+
 struct Data {
  public:
   ~Data() { util::debug(log_tag + "data struct destroyed"s); }
 
   bool draw_bar_border, fill_bars, is_visible, rounded_corners;
 
+  // The x geometry and the axis labels only change on resize or when the x data or its presentation change
+
+  bool geometry_valid, labels_valid;
+
   int x_axis_height, n_x_decimals, n_y_decimals;
 
+  int geometry_width, labels_width, labels_height;
+
+  uint n_frames;
+
+  gint64 snapshot_time;  // microseconds spent in snapshot since the last report
+
   float mouse_y, mouse_x, margin, line_width;
 
   float x_min, x_max, y_min, y_max;
@@ -49,6 +61,18 @@ struct Data {
 
   std::vector<float> y_axis, x_axis, x_axis_log, objects_x;
 
+  // When a waveform is set the x and y data above are read from it at the current width
+
+  uint waveform_columns = 0U;
+
+  std::vector<float> waveform_x, waveform_y;
+
+  std::shared_ptr<const WaveformPyramid> waveform;
+
+  GskRenderNode* x_labels_node = nullptr;
+
+  PangoFontDescription* font_description = nullptr;
+
   std::locale user_locale = std::locale(setlocale(LC_ALL, nullptr));
 };
 
@@ -62,12 +86,19 @@ struct _Chart {
 
 G_DEFINE_TYPE(Chart, chart, GTK_TYPE_WIDGET)
 
+void invalidate_x_cache(Chart* self) {
+  self->data->geometry_valid = false;
+  self->data->labels_valid = false;
+}
+
 void set_chart_type(Chart* self, const ChartType& value) {
   self->data->chart_type = value;
 }
 
 void set_chart_scale(Chart* self, const ChartScale& value) {
   self->data->chart_scale = value;
+
+  invalidate_x_cache(self);
 }
 
 void set_background_color(Chart* self, GdkRGBA color) {
@@ -80,10 +111,14 @@ void set_color(Chart* self, GdkRGBA color) {
 
 void set_axis_labels_color(Chart* self, GdkRGBA color) {
   self->data->color_axis_labels = color;
+
+  self->data->labels_valid = false;
 }
 
 void set_line_width(Chart* self, const double& value) {
   self->data->line_width = value;
+
+  self->data->geometry_valid = false;
 }
 
 void set_draw_bar_border(Chart* self, const bool& v) {
@@ -100,6 +135,8 @@ void set_fill_bars(Chart* self, const bool& v) {
 
 void set_n_x_decimals(Chart* self, const int& v) {
   self->data->n_x_decimals = v;
+
+  self->data->labels_valid = false;
 }
 
 void set_n_y_decimals(Chart* self, const int& v) {
@@ -108,6 +145,8 @@ void set_n_y_decimals(Chart* self, const int& v) {
 
 void set_x_unit(Chart* self, const std::string& value) {
   self->data->x_unit = value;
+
+  self->data->labels_valid = false;
 }
 
 void set_y_unit(Chart* self, const std::string& value) {
@@ -116,17 +155,15 @@ void set_y_unit(Chart* self, const std::string& value) {
 
 void set_margin(Chart* self, const double& v) {
   self->data->margin = v;
+
+  invalidate_x_cache(self);
 }
 
 auto get_is_visible(Chart* self) -> bool {
   return self->data->is_visible;
 }
 
-void set_x_data(Chart* self, const std::vector<float>& x) {
-  if (self == nullptr || x.empty()) {
-    return;
-  }
-
+void store_x_data(Chart* self, const std::vector<float>& x) {
   self->data->x_axis = x;
 
   self->data->x_min = std::ranges::min(x);
@@ -151,13 +188,11 @@ void set_x_data(Chart* self, const std::vector<float>& x) {
   std::ranges::for_each(self->data->x_axis_log, [&](auto& v) {
     v = (v - self->data->x_min_log) / (self->data->x_max_log - self->data->x_min_log);
   });
-}
 
-void set_y_data(Chart* self, const std::vector<float>& y) {
-  if (self == nullptr || y.empty()) {
-    return;
-  }
+  invalidate_x_cache(self);
+}
 
+void store_y_data(Chart* self, const std::vector<float>& y) {
   self->data->y_axis = y;
 
   self->data->y_min = std::ranges::min(y);
@@ -171,10 +206,58 @@ void set_y_data(Chart* self, const std::vector<float>& y) {
     std::ranges::for_each(self->data->y_axis,
                           [&](auto& v) { v = (v - self->data->y_min) / (self->data->y_max - self->data->y_min); });
   }
+}
+
+void set_x_data(Chart* self, const std::vector<float>& x) {
+  if (self == nullptr || x.empty()) {
+    return;
+  }
+
+  self->data->waveform = nullptr;
+
+  store_x_data(self, x);
+}
+
+void set_y_data(Chart* self, const std::vector<float>& y) {
+  if (self == nullptr || y.empty()) {
+    return;
+  }
+
+  self->data->waveform = nullptr;
+
+  store_y_data(self, y);
 
   gtk_widget_queue_draw(GTK_WIDGET(self));
 }
 
+void set_waveform(Chart* self, std::shared_ptr<const WaveformPyramid> waveform) {
+  if (self == nullptr || waveform == nullptr || waveform->size() == 0U) {
+    return;
+  }
+
+  self->data->waveform = std::move(waveform);
+  self->data->waveform_columns = 0U;
+
+  gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+// Asks the pyramid for one column per pixel. This only happens again when the width changes.
+
+void update_waveform(Chart* self, const int& width) {
+  const auto n_columns = static_cast<uint>(std::max(width, 1));
+
+  if (n_columns == self->data->waveform_columns) {
+    return;
+  }
+
+  self->data->waveform->query(n_columns, self->data->waveform_x, self->data->waveform_y);
+
+  store_x_data(self, self->data->waveform_x);
+  store_y_data(self, self->data->waveform_y);
+
+  self->data->waveform_columns = n_columns;
+}
+
 void on_pointer_motion(GtkEventControllerMotion* controller, double x, double y, Chart* self) {
   const int width = gtk_widget_get_allocated_width(GTK_WIDGET(self));
   const int height = gtk_widget_get_allocated_height(GTK_WIDGET(self));
@@ -213,13 +296,16 @@ void on_pointer_motion(GtkEventControllerMotion* controller, double x, double y,
   }
 }
 
-auto draw_unit(Chart* self, GtkSnapshot* snapshot, const int& width, const int& height, const std::string& unit) {
-  auto* layout = gtk_widget_create_pango_layout(GTK_WIDGET(self), unit.c_str());
+auto create_layout(Chart* self, const std::string& text) -> PangoLayout* {
+  auto* layout = gtk_widget_create_pango_layout(GTK_WIDGET(self), text.c_str());
+
+  pango_layout_set_font_description(layout, self->data->font_description);
 
-  auto* description = pango_font_description_from_string("monospace bold");
+  return layout;
+}
 
-  pango_layout_set_font_description(layout, description);
-  pango_font_description_free(description);
+void draw_unit(Chart* self, GtkSnapshot* snapshot, const int& width, const int& height, const std::string& unit) {
+  auto* layout = create_layout(self, unit);
 
   int text_width = 0;
   int text_height = 0;
@@ -280,12 +366,7 @@ auto draw_x_labels(Chart* self, GtkSnapshot* snapshot, const int& width, const i
   for (size_t n = 0U; n < labels.size() - 1; n++) {
     const auto msg = fmt::format(self->data->user_locale, " {0:.{1}Lf} ", labels[n], self->data->n_x_decimals);
 
-    auto* layout = gtk_widget_create_pango_layout(GTK_WIDGET(self), msg.c_str());
-
-    auto* description = pango_font_description_from_string("monospace bold");
-
-    pango_layout_set_font_description(layout, description);
-    pango_font_description_free(description);
+    auto* layout = create_layout(self, msg);
 
     int text_width = 0;
     int text_height = 0;
@@ -313,196 +394,226 @@ auto draw_x_labels(Chart* self, GtkSnapshot* snapshot, const int& width, const i
   return 0;
 }
 
-void snapshot(GtkWidget* widget, GtkSnapshot* snapshot) {
-  auto* self = EE_CHART(widget);
+/*
+  The labels are recorded once into a render node that is appended as is to every frame until the widget is resized
+  or the x data changes.
+*/
 
-  switch (self->data->chart_scale) {
-    case ChartScale::logarithmic: {
-      if (self->data->y_axis.size() != self->data->x_axis_log.size()) {
-        return;
-      }
+void update_x_labels(Chart* self, const int& width, const int& height) {
+  if (self->data->labels_valid && self->data->labels_width == width && self->data->labels_height == height) {
+    return;
+  }
 
-      break;
-    }
-    case ChartScale::linear: {
-      if (self->data->y_axis.size() != self->data->x_axis.size()) {
-        return;
-      }
+  if (self->data->x_labels_node != nullptr) {
+    gsk_render_node_unref(self->data->x_labels_node);
+  }
 
-      break;
-    }
+  auto* labels_snapshot = gtk_snapshot_new();
+
+  self->data->x_axis_height = draw_x_labels(self, labels_snapshot, width, height);
+
+  self->data->x_labels_node = gtk_snapshot_free_to_node(labels_snapshot);  // nullptr if nothing was drawn
+
+  self->data->labels_width = width;
+  self->data->labels_height = height;
+  self->data->labels_valid = true;
+}
+
+void update_geometry(Chart* self, const int& width) {
+  if (self->data->geometry_valid && self->data->geometry_width == width) {
+    return;
   }
 
-  int width = gtk_widget_get_width(widget);
-  int height = gtk_widget_get_height(widget);
+  const auto& x = (self->data->chart_scale == ChartScale::logarithmic) ? self->data->x_axis_log : self->data->x_axis;
 
-  auto widget_rectangle = GRAPHENE_RECT_INIT(0.0F, 0.0F, static_cast<float>(width), static_cast<float>(height));
+  const double usable_width = width - 2 * (self->data->line_width + self->data->margin * width);
 
-  gtk_snapshot_append_color(snapshot, &self->data->background_color, &widget_rectangle);
+  for (size_t n = 0; n < x.size(); n++) {
+    self->data->objects_x[n] = usable_width * x[n] + self->data->line_width + self->data->margin * width;
+  }
 
-  if (const auto n_points = self->data->y_axis.size(); n_points > 0) {
-    double usable_width = width - 2 * (self->data->line_width + self->data->margin * width);
+  self->data->geometry_width = width;
+  self->data->geometry_valid = true;
+}
 
-    int usable_height = static_cast<int>(height - self->data->margin * height) - self->data->x_axis_height;
+void add_rounded_rectangle(cairo_t* ctx, double x, double y, double w, double h, double radius) {
+  radius = std::min({radius, 0.5 * w, 0.5 * h});
 
-    switch (self->data->chart_scale) {
-      case ChartScale::logarithmic: {
-        for (size_t n = 0; n < n_points; n++) {
-          self->data->objects_x[n] =
-              usable_width * self->data->x_axis_log[n] + self->data->line_width + self->data->margin * width;
-        }
+  if (radius <= 0.0) {
+    cairo_rectangle(ctx, x, y, w, h);
 
-        break;
-      }
-      case ChartScale::linear: {
-        for (size_t n = 0; n < n_points; n++) {
-          self->data->objects_x[n] =
-              usable_width * self->data->x_axis[n] + self->data->line_width + self->data->margin * width;
-        }
+    return;
+  }
 
-        break;
-      }
-    }
+  cairo_new_sub_path(ctx);
+  cairo_arc(ctx, x + w - radius, y + radius, radius, -0.5 * G_PI, 0.0);
+  cairo_arc(ctx, x + w - radius, y + h - radius, radius, 0.0, 0.5 * G_PI);
+  cairo_arc(ctx, x + radius, y + h - radius, radius, 0.5 * G_PI, G_PI);
+  cairo_arc(ctx, x + radius, y + radius, radius, G_PI, 1.5 * G_PI);
+  cairo_close_path(ctx);
+}
 
-    self->data->x_axis_height = draw_x_labels(self, snapshot, width, height);
+/*
+  Every chart type builds a single path for the whole series and fills or strokes it once. This gives one render
+  node per frame instead of one clip and color node per bar.
+*/
 
-    auto border_color = std::to_array({self->data->color, self->data->color, self->data->color, self->data->color});
+void draw_series(Chart* self, GtkSnapshot* snapshot, const graphene_rect_t& bounds, const int& width, const int& height) {
+  const auto n_points = self->data->y_axis.size();
 
-    auto border_width =
-        std::to_array({static_cast<float>(self->data->line_width), static_cast<float>(self->data->line_width),
-                       static_cast<float>(self->data->line_width), static_cast<float>(self->data->line_width)});
+  const auto margin_y = self->data->margin * height;
 
-    float radius = (self->data->rounded_corners == true) ? 5.0F : 0.0F;
+  float usable_height = static_cast<int>(height - margin_y) - self->data->x_axis_height;
 
-    switch (self->data->chart_type) {
-      case ChartType::bar: {
-        float dw = static_cast<float>(width) / static_cast<float>(n_points);
+  const float radius = (self->data->rounded_corners) ? 5.0F : 0.0F;
 
-        for (uint n = 0U; n < n_points; n++) {
-          float bar_height = static_cast<float>(usable_height) * self->data->y_axis[n];
+  // Borders are drawn inside the outline like gtk_snapshot_append_border does
 
-          float rect_x = self->data->objects_x[n];
-          float rect_y = self->data->margin * height + static_cast<float>(usable_height) - bar_height;
-          float rect_height = bar_height;
-          float rect_width = dw;
+  const double inset = (self->data->fill_bars) ? 0.0 : 0.5 * self->data->line_width;
 
-          if (self->data->draw_bar_border) {
-            rect_width -= self->data->line_width;
-          }
+  auto* ctx = gtk_snapshot_append_cairo(snapshot, &bounds);
 
-          auto bar_rectangle = GRAPHENE_RECT_INIT(rect_x, rect_y, rect_width, rect_height);
+  cairo_set_source_rgba(ctx, self->data->color.red, self->data->color.green, self->data->color.blue,
+                        self->data->color.alpha);
 
-          GskRoundedRect outline;
+  cairo_set_line_width(ctx, self->data->line_width);
 
-          gsk_rounded_rect_init_from_rect(&outline, &bar_rectangle, radius);
+  switch (self->data->chart_type) {
+    case ChartType::bar: {
+      float dw = static_cast<float>(width) / static_cast<float>(n_points);
 
-          if (self->data->fill_bars) {
-            gtk_snapshot_push_rounded_clip(snapshot, &outline);
+      for (uint n = 0U; n < n_points; n++) {
+        float bar_height = usable_height * self->data->y_axis[n];
 
-            gtk_snapshot_append_color(snapshot, &self->data->color, &outline.bounds);
+        float rect_x = self->data->objects_x[n];
+        float rect_y = margin_y + usable_height - bar_height;
+        float rect_width = dw;
 
-            gtk_snapshot_pop(snapshot);
-          } else {
-            gtk_snapshot_append_border(snapshot, &outline, border_width.data(), border_color.data());
-          }
+        if (self->data->draw_bar_border) {
+          rect_width -= self->data->line_width;
         }
 
-        break;
+        if (bar_height <= 0.0F || rect_width <= 0.0F) {
+          continue;
+        }
+
+        add_rounded_rectangle(ctx, rect_x + inset, rect_y + inset, rect_width - 2.0 * inset,
+                              bar_height - 2.0 * inset, radius);
       }
-      case ChartType::dots: {
-        float dw = static_cast<float>(width) / static_cast<float>(n_points);
 
-        usable_height -= radius;  // this avoids the dots being drawn over the axis label
+      break;
+    }
+    case ChartType::dots: {
+      float dw = static_cast<float>(width) / static_cast<float>(n_points);
 
-        for (uint n = 0U; n < n_points; n++) {
-          float dot_y = static_cast<float>(usable_height) * self->data->y_axis[n];
+      usable_height -= radius;  // this avoids the dots being drawn over the axis label
 
-          float rect_x = self->data->objects_x[n];
-          float rect_y = self->data->margin * height + radius + static_cast<float>(usable_height) - dot_y;
-          float rect_width = dw;
+      for (uint n = 0U; n < n_points; n++) {
+        float dot_y = usable_height * self->data->y_axis[n];
 
-          if (self->data->draw_bar_border) {
-            rect_width -= self->data->line_width;
-          }
+        float rect_x = self->data->objects_x[n];
+        float rect_y = margin_y + radius + usable_height - dot_y;
+        float rect_width = dw;
 
-          auto rectangle = GRAPHENE_RECT_INIT(rect_x - radius, rect_y - radius, rect_width, rect_width);
+        if (self->data->draw_bar_border) {
+          rect_width -= self->data->line_width;
+        }
 
-          GskRoundedRect outline;
+        if (rect_width <= 0.0F) {
+          continue;
+        }
 
-          gsk_rounded_rect_init_from_rect(&outline, &rectangle, radius);
+        add_rounded_rectangle(ctx, rect_x - radius + inset, rect_y - radius + inset, rect_width - 2.0 * inset,
+                              rect_width - 2.0 * inset, radius);
+      }
 
-          if (self->data->fill_bars) {
-            gtk_snapshot_push_rounded_clip(snapshot, &outline);
+      break;
+    }
+    case ChartType::line: {
+      if (self->data->fill_bars) {
+        cairo_move_to(ctx, self->data->margin * width, margin_y + usable_height);
+      } else {
+        const auto point_height = self->data->y_axis.front() * usable_height;
 
-            gtk_snapshot_append_color(snapshot, &self->data->color, &outline.bounds);
+        cairo_move_to(ctx, self->data->objects_x.front(), margin_y + usable_height - point_height);
+      }
 
-            gtk_snapshot_pop(snapshot);
-          } else {
-            gtk_snapshot_append_border(snapshot, &outline, border_width.data(), border_color.data());
-          }
-        }
+      for (uint n = 0U; n < n_points - 1U; n++) {
+        const auto next_point_height = self->data->y_axis[n + 1] * usable_height;
 
-        break;
+        cairo_line_to(ctx, self->data->objects_x[n + 1], margin_y + usable_height - next_point_height);
       }
-      case ChartType::line: {
-        auto* ctx = gtk_snapshot_append_cairo(snapshot, &widget_rectangle);
 
-        cairo_set_source_rgba(ctx, self->data->color.red, self->data->color.green, self->data->color.blue,
-                              self->data->color.alpha);
+      if (self->data->fill_bars) {
+        cairo_line_to(ctx, self->data->objects_x.back(), margin_y + usable_height);
 
-        if (self->data->fill_bars) {
-          cairo_move_to(ctx, self->data->margin * width,
-                        self->data->margin * height + static_cast<float>(usable_height));
-        } else {
-          const auto point_height = self->data->y_axis.front() * static_cast<float>(usable_height);
+        cairo_close_path(ctx);
+      }
 
-          cairo_move_to(ctx, self->data->objects_x.front(),
-                        self->data->margin * height + static_cast<float>(usable_height) - point_height);
-        }
+      break;
+    }
+  }
 
-        for (uint n = 0U; n < n_points - 1U; n++) {
-          const auto next_point_height = self->data->y_axis[n + 1] * static_cast<float>(usable_height);
+  if (self->data->fill_bars) {
+    cairo_fill(ctx);
+  } else {
+    cairo_stroke(ctx);
+  }
 
-          cairo_line_to(ctx, self->data->objects_x[n + 1],
-                        self->data->margin * height + static_cast<float>(usable_height) - next_point_height);
-        }
+  cairo_destroy(ctx);
+}
 
-        if (self->data->fill_bars) {
-          cairo_line_to(ctx, self->data->objects_x.back(),
-                        self->data->margin * height + static_cast<float>(usable_height));
+void snapshot(GtkWidget* widget, GtkSnapshot* snapshot) {
+  auto* self = EE_CHART(widget);
 
-          cairo_move_to(ctx, self->data->objects_x.back(),
-                        self->data->margin * height + static_cast<float>(usable_height));
+  if (self->data->waveform != nullptr) {
+    update_waveform(self, gtk_widget_get_width(widget));
+  }
 
-          cairo_close_path(ctx);
-        }
+  switch (self->data->chart_scale) {
+    case ChartScale::logarithmic: {
+      if (self->data->y_axis.size() != self->data->x_axis_log.size()) {
+        return;
+      }
 
-        cairo_set_line_width(ctx, self->data->line_width);
+      break;
+    }
+    case ChartScale::linear: {
+      if (self->data->y_axis.size() != self->data->x_axis.size()) {
+        return;
+      }
 
-        if (self->data->fill_bars) {
-          cairo_fill(ctx);
-        } else {
-          cairo_stroke(ctx);
-        }
+      break;
+    }
+  }
 
-        cairo_destroy(ctx);
+  const auto start_time = g_get_monotonic_time();
 
-        break;
-      }
+  int width = gtk_widget_get_width(widget);
+  int height = gtk_widget_get_height(widget);
+
+  auto widget_rectangle = GRAPHENE_RECT_INIT(0.0F, 0.0F, static_cast<float>(width), static_cast<float>(height));
+
+  gtk_snapshot_append_color(snapshot, &self->data->background_color, &widget_rectangle);
+
+  if (const auto n_points = self->data->y_axis.size(); n_points > 0) {
+    update_geometry(self, width);
+
+    update_x_labels(self, width, height);
+
+    if (self->data->x_labels_node != nullptr) {
+      gtk_snapshot_append_node(snapshot, self->data->x_labels_node);
     }
 
+    draw_series(self, snapshot, widget_rectangle, width, height);
+
     if (gtk_event_controller_motion_contains_pointer(GTK_EVENT_CONTROLLER_MOTION(self->controller_motion)) != 0) {
       // We leave a withespace at the end to not stick the string at the window border.
       const auto msg = fmt::format(self->data->user_locale, "x = {0:.{1}Lf} {2} y = {3:.{4}Lf} {5} ",
                                    self->data->mouse_x, self->data->n_x_decimals, self->data->x_unit,
                                    self->data->mouse_y, self->data->n_y_decimals, self->data->y_unit);
 
-      auto* layout = gtk_widget_create_pango_layout(GTK_WIDGET(self), msg.c_str());
-
-      auto* description = pango_font_description_from_string("monospace bold");
-
-      pango_layout_set_font_description(layout, description);
-      pango_font_description_free(description);
+      auto* layout = create_layout(self, msg);
 
       int text_width = 0;
       int text_height = 0;
@@ -522,6 +633,18 @@ void snapshot(GtkWidget* widget, GtkSnapshot* snapshot) {
       g_object_unref(layout);
     }
   }
+
+  // Frame time counter. Run with G_MESSAGES_DEBUG=easyeffects to see it.
+
+  self->data->snapshot_time += g_get_monotonic_time() - start_time;
+
+  if (++self->data->n_frames == frame_time_report_interval) {
+    util::debug(log_tag + "average snapshot time: "s +
+                std::to_string(self->data->snapshot_time / static_cast<gint64>(self->data->n_frames)) + " us"s);
+
+    self->data->n_frames = 0U;
+    self->data->snapshot_time = 0;
+  }
 }
 
 void unroot(GtkWidget* widget) {
@@ -532,9 +655,25 @@ void unroot(GtkWidget* widget) {
   GTK_WIDGET_CLASS(chart_parent_class)->unmap(widget);
 }
 
+// The cached labels were laid out with the old font and scale. They are drawn again on the next snapshot.
+
+void css_changed(GtkWidget* widget, GtkCssStyleChange* change) {
+  auto* self = EE_CHART(widget);
+
+  self->data->labels_valid = false;
+
+  GTK_WIDGET_CLASS(chart_parent_class)->css_changed(widget, change);
+}
+
 void finalize(GObject* object) {
   auto* self = EE_CHART(object);
 
+  if (self->data->x_labels_node != nullptr) {
+    gsk_render_node_unref(self->data->x_labels_node);
+  }
+
+  pango_font_description_free(self->data->font_description);
+
   delete self->data;
 
   util::debug(log_tag + "finalized"s);
@@ -550,6 +689,7 @@ void chart_class_init(ChartClass* klass) {
 
   widget_class->snapshot = snapshot;
   widget_class->unroot = unroot;
+  widget_class->css_changed = css_changed;
 
   gtk_widget_class_set_template_from_resource(widget_class, (tags::app::path + "/ui/chart.ui").c_str());
 }
@@ -562,7 +702,14 @@ void chart_init(Chart* self) {
   self->data->draw_bar_border = true;
   self->data->fill_bars = true;
   self->data->is_visible = true;
+  self->data->geometry_valid = false;
+  self->data->labels_valid = false;
   self->data->x_axis_height = 0;
+  self->data->geometry_width = 0;
+  self->data->labels_width = 0;
+  self->data->labels_height = 0;
+  self->data->n_frames = 0U;
+  self->data->snapshot_time = 0;
   self->data->n_x_decimals = 1;
   self->data->n_y_decimals = 1;
   self->data->line_width = 2.0F;
@@ -581,6 +728,8 @@ void chart_init(Chart* self) {
   self->data->chart_type = ChartType::bar;
   self->data->chart_scale = ChartScale::logarithmic;
 
+  self->data->font_description = pango_font_description_from_string("monospace bold");
+
   self->controller_motion = gtk_event_controller_motion_new();
 
   g_signal_connect(self->controller_motion, "motion", G_CALLBACK(on_pointer_motion), self);
@@ -591,6 +740,14 @@ void chart_init(Chart* self) {
   g_signal_connect(GTK_WIDGET(self), "show",
                    G_CALLBACK(+[](GtkWidget* widget, Chart* self) { self->data->is_visible = true; }), self);
 
+  g_signal_connect(GTK_WIDGET(self), "notify::scale-factor",
+                   G_CALLBACK(+[](GtkWidget* widget, GParamSpec* pspec, Chart* self) {
+                     self->data->labels_valid = false;
+
+                     gtk_widget_queue_draw(widget);
+                   }),
+                   self);
+
   gtk_widget_add_controller(GTK_WIDGET(self), self->controller_motion);
 }
 
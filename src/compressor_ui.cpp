@@ -150,15 +150,9 @@ void setup(CompressorBox* self,
     }
   }
 
-  self->data->connections.push_back(compressor->input_level.connect([=](const float& left, const float& right) {
-    update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                 self->input_level_right_label, left, right);
-  }));
-
-  self->data->connections.push_back(compressor->output_level.connect([=](const float& left, const float& right) {
-    update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                 self->output_level_right_label, left, right);
-  }));
+  add_level_meters_tick(GTK_WIDGET(self), compressor, self->input_level_left, self->input_level_left_label,
+                        self->input_level_right, self->input_level_right_label, self->output_level_left,
+                        self->output_level_left_label, self->output_level_right, self->output_level_right_label);
 
   self->data->connections.push_back(compressor->reduction.connect([=](const double& value) {
     gtk_label_set_text(self->gain_label, fmt::format("{0:.0f}", util::linear_to_db(value)).c_str());
@@ -19,19 +19,12 @@
 
 #include "convolver.hpp"
 
-namespace {
-
-constexpr auto CONVPROC_SCHEDULER_PRIORITY = 0;
-
-constexpr auto CONVPROC_SCHEDULER_CLASS = SCHED_FIFO;
-
-}  // namespace
-
 Convolver::Convolver(const std::string& tag,
                      const std::string& schema,
                      const std::string& schema_path,
                      PipeManager* pipe_manager)
-    : PluginBase(tag, plugin_name::convolver, schema, schema_path, pipe_manager) {
+    : PluginBase(tag, plugin_name::convolver, schema, schema_path, pipe_manager),
+      conv(std::make_unique<PartitionedConvolver>(log_tag + name + " ")) {
   gconnections.push_back(g_signal_connect(settings, "changed::ir-width",
                                           G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
                                             auto self = static_cast<Convolver*>(user_data);
@@ -73,17 +66,57 @@ Convolver::Convolver(const std::string& tag,
                                               self->set_kernel_stereo_width();
                                               self->apply_kernel_autogain();
 
-                                              self->setup_zita();
+                                              self->setup_convolver();
+
+                                              self->data_mutex.lock();
+
+                                              self->ready = self->kernel_is_initialized && self->convolver_ready;
+
+                                              self->data_mutex.unlock();
+                                            }
+                                          }),
+                                          this));
+
+  gconnections.push_back(g_signal_connect(settings, "changed::zero-latency",
+                                          G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                                            auto self = static_cast<Convolver*>(user_data);
+
+                                            self->data_mutex.lock();
+
+                                            self->ready = false;
+
+                                            self->zero_latency = g_settings_get_boolean(settings, key) != 0;
+
+                                            self->data_mutex.unlock();
+
+                                            if (self->n_samples == 0U || self->rate == 0U) {
+                                              return;
+                                            }
+
+                                            self->data_L.resize(0);
+                                            self->data_R.resize(0);
+
+                                            self->deque_out_L.resize(0);
+                                            self->deque_out_R.resize(0);
+
+                                            self->latency_n_frames = 0U;
+
+                                            self->notify_latency = true;
+
+                                            if (self->kernel_is_initialized) {
+                                              self->setup_convolver();
 
                                               self->data_mutex.lock();
 
-                                              self->ready = self->kernel_is_initialized && self->zita_ready;
+                                              self->ready = self->kernel_is_initialized && self->convolver_ready;
 
                                               self->data_mutex.unlock();
                                             }
                                           }),
                                           this));
 
+  zero_latency = g_settings_get_boolean(settings, "zero-latency") != 0;
+
   setup_input_output_gain();
 }
 
@@ -102,13 +135,7 @@ Convolver::~Convolver() {
 
   ready = false;
 
-  if (conv != nullptr) {
-    conv->stop_process();
-
-    conv->cleanup();
-
-    delete conv;
-  }
+  conv.reset();
 
   util::debug(log_tag + name + " destroyed");
 }
@@ -117,8 +144,8 @@ void Convolver::setup() {
   ready = false;
 
   /*
-    As zita uses fftw we have to be careful when reinitializing it. The thread that creates the fftw plan has to be the
-    same that destroys it. Otherwise segmentation faults can happen. As we do not want to do this initializing in the
+    As our convolver uses fftw we have to be careful when reinitializing it. The thread that creates the fftw plan has to
+    be the same that destroys it. Otherwise segmentation faults can happen. As we do not want to do this initializing in the
     plugin realtime thread we send it to the main thread through g_idle_add().connect_once
   */
 
@@ -156,12 +183,12 @@ void Convolver::setup() {
       set_kernel_stereo_width();
       apply_kernel_autogain();
 
-      setup_zita();
+      setup_convolver();
     }
 
     std::scoped_lock<std::mutex> lock(data_mutex);
 
-    ready = kernel_is_initialized && zita_ready;
+    ready = kernel_is_initialized && convolver_ready;
   });
 }
 
@@ -182,7 +209,12 @@ void Convolver::process(std::span<float>& left_in,
     apply_gain(left_in, right_in, input_gain);
   }
 
-  if (n_samples_is_power_of_2) {
+  if (zero_latency) {
+    std::copy(left_in.begin(), left_in.end(), left_out.begin());
+    std::copy(right_in.begin(), right_in.end(), right_out.begin());
+
+    process_zero_latency(left_out, right_out);
+  } else if (n_samples_is_power_of_2) {
     std::copy(left_in.begin(), left_in.end(), left_out.begin());
     std::copy(right_in.begin(), right_in.end(), right_out.begin());
 
@@ -405,74 +437,141 @@ void Convolver::set_kernel_stereo_width() {
   }
 }
 
-void Convolver::setup_zita() {
-  zita_ready = false;
+void Convolver::setup_convolver() {
+  convolver_ready = false;
 
   if (n_samples == 0U || !kernel_is_initialized) {
     return;
   }
 
-  const uint max_convolution_size = kernel_L.size();
-  const uint buffer_size = get_zita_buffer_size();
+  /*
+    In zero latency mode the convolver only sees the taps that come after the head. When the impulse is not longer
+    than the head a single null tap is used so that the engine can still be configured.
+  */
 
-  if (conv != nullptr) {
-    conv->stop_process();
+  std::span<const float> engine_kernel_L{kernel_L};
+  std::span<const float> engine_kernel_R{kernel_R};
 
-    conv->cleanup();
+  std::vector<float> null_tail(1, 0.0F);
 
-    delete conv;
+  if (zero_latency) {
+    if (kernel_L.size() > head_size) {
+      engine_kernel_L = std::span{kernel_L.begin() + head_size, kernel_L.end()};
+      engine_kernel_R = std::span{kernel_R.begin() + head_size, kernel_R.end()};
+    } else {
+      engine_kernel_L = null_tail;
+      engine_kernel_R = null_tail;
+    }
+
+    setup_zero_latency_buffers();
   }
 
-  conv = new Convproc();
+  if (!conv->configure(get_convolver_block_size(), engine_kernel_L, engine_kernel_R)) {
+    util::warning(log_tag + name + " can't initialise the convolution engine");
 
-  conv->set_options(0);
+    return;
+  }
 
-  int ret = conv->configure(2, 2, max_convolution_size, buffer_size, buffer_size, buffer_size, 0.0F /*density*/);
+  convolver_ready = true;
 
-  if (ret != 0) {
-    util::warning(log_tag + name + " can't initialise zita-convolver engine: " + util::to_string(ret, ""));
+  util::debug(log_tag + name + ": convolver is ready");
+}
 
-    return;
+auto Convolver::get_convolver_block_size() -> uint {
+  if (zero_latency) {
+    return head_size;
   }
 
-  ret = conv->impdata_create(0, 0, 1, kernel_L.data(), 0, static_cast<int>(kernel_L.size()));
+  if (n_samples_is_power_of_2) {
+    return n_samples;
+  }
 
-  if (ret != 0) {
-    util::warning(log_tag + name + " left impdata_create failed: " + util::to_string(ret));
+  return blocksize;
+}
 
-    return;
-  }
+void Convolver::setup_zero_latency_buffers() {
+  const auto head_length = std::min(static_cast<size_t>(head_size), kernel_L.size());
 
-  ret = conv->impdata_create(1, 1, 1, kernel_R.data(), 0, static_cast<int>(kernel_R.size()));
+  head_kernel_L.resize(head_length);
+  head_kernel_R.resize(head_length);
 
-  if (ret != 0) {
-    util::warning(log_tag + name + " right impdata_create failed: " + util::to_string(ret, ""));
+  std::copy_n(kernel_L.begin(), head_length, head_kernel_L.begin());
+  std::copy_n(kernel_R.begin(), head_length, head_kernel_R.begin());
 
-    return;
-  }
+  head_history_L.resize(head_length - 1U + n_samples);
+  head_history_R.resize(head_length - 1U + n_samples);
 
-  ret = conv->start_process(CONVPROC_SCHEDULER_PRIORITY, CONVPROC_SCHEDULER_CLASS);
+  std::ranges::fill(head_history_L, 0.0F);
+  std::ranges::fill(head_history_R, 0.0F);
 
-  if (ret != 0) {
-    util::warning(log_tag + name + " start_process failed: " + util::to_string(ret, ""));
+  tail_in_L.resize(head_size);
+  tail_in_R.resize(head_size);
 
-    conv->stop_process();
-    conv->cleanup();
+  /*
+    The tail output has to be delayed by head_size samples. Its buffer starts filled with that many zeros. After that
+    it never holds more than head_size + n_samples values.
+  */
 
-    return;
-  }
+  tail_out_L.resize(head_size + n_samples);
+  tail_out_R.resize(head_size + n_samples);
+
+  std::ranges::fill(tail_out_L, 0.0F);
+  std::ranges::fill(tail_out_R, 0.0F);
 
-  zita_ready = true;
+  tail_in_count = 0U;
+  tail_out_count = head_size;
 
-  util::debug(log_tag + name + ": zita is ready");
+  latency_n_frames = 0U;
+
+  notify_latency = true;
 }
 
-auto Convolver::get_zita_buffer_size() -> uint {
-  if (n_samples_is_power_of_2) {
-    return n_samples;
+void Convolver::process_zero_latency(std::span<float>& left_out, std::span<float>& right_out) {
+  const size_t n_frames = left_out.size();
+
+  // feeding the partitioned convolver with the tail
+
+  for (size_t offset = 0U; offset < n_frames;) {
+    const size_t count = std::min(static_cast<size_t>(head_size - tail_in_count), n_frames - offset);
+
+    std::copy_n(left_out.begin() + offset, count, tail_in_L.begin() + tail_in_count);
+    std::copy_n(right_out.begin() + offset, count, tail_in_R.begin() + tail_in_count);
+
+    tail_in_count += count;
+    offset += count;
+
+    if (tail_in_count == head_size) {
+      do_convolution(tail_in_L, tail_in_R);
+
+      if (!convolver_ready) {
+        std::ranges::fill(tail_in_L, 0.0F);
+        std::ranges::fill(tail_in_R, 0.0F);
+      }
+
+      std::copy(tail_in_L.begin(), tail_in_L.end(), tail_out_L.begin() + tail_out_count);
+      std::copy(tail_in_R.begin(), tail_in_R.end(), tail_out_R.begin() + tail_out_count);
+
+      tail_out_count += head_size;
+      tail_in_count = 0U;
+    }
   }
 
-  return blocksize;
+  // the head is convolved directly
+
+  ForkJoin::get().run([&] { direct_fir(head_kernel_L, head_history_L, left_out); },
+                      [&] { direct_fir(head_kernel_R, head_history_R, right_out); });
+
+  // adding the delayed tail
+
+  for (size_t n = 0U; n < n_frames; n++) {
+    left_out[n] += tail_out_L[n];
+    right_out[n] += tail_out_R[n];
+  }
+
+  std::copy(tail_out_L.begin() + n_frames, tail_out_L.begin() + tail_out_count, tail_out_L.begin());
+  std::copy(tail_out_R.begin() + n_frames, tail_out_R.begin() + tail_out_count, tail_out_R.begin());
+
+  tail_out_count -= n_frames;
 }
 
 auto Convolver::get_latency_seconds() -> float {
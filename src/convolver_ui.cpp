@@ -44,7 +44,9 @@ struct Data {
 
   std::vector<gulong> gconnections;
 
-  std::vector<float> left_mag, right_mag, time_axis, left_spectrum, right_spectrum, freq_axis;
+  std::vector<float> left_spectrum, right_spectrum, freq_axis;
+
+  std::shared_ptr<const WaveformPyramid> left_waveform, right_waveform;
 };
 
 struct _ConvolverBox {
@@ -64,6 +66,8 @@ struct _ConvolverBox {
 
   GtkSpinButton* ir_width;
 
+  GtkToggleButton* zero_latency;
+
   GtkCheckButton *check_left, *check_right;
 
   GtkToggleButton *show_fft, *enable_log_scale;
@@ -123,7 +127,7 @@ void plot_fft(ConvolverBox* self) {
 }
 
 void plot_waveform(ConvolverBox* self) {
-  if (self->data->time_axis.empty() || self->data->left_spectrum.empty() || self->data->right_spectrum.empty()) {
+  if (self->data->left_waveform == nullptr || self->data->right_waveform == nullptr) {
     return;
   }
 
@@ -135,12 +139,10 @@ void plot_waveform(ConvolverBox* self) {
   ui::chart::set_n_y_decimals(self->chart, 2);
   ui::chart::set_x_unit(self->chart, "s");
 
-  ui::chart::set_x_data(self->chart, self->data->time_axis);
-
   if (gtk_check_button_get_active(self->check_left) != 0) {
-    ui::chart::set_y_data(self->chart, self->data->left_mag);
+    ui::chart::set_waveform(self->chart, self->data->left_waveform);
   } else if (gtk_check_button_get_active(self->check_right) != 0) {
-    ui::chart::set_y_data(self->chart, self->data->right_mag);
+    ui::chart::set_waveform(self->chart, self->data->right_waveform);
   }
 }
 
@@ -162,9 +164,11 @@ void on_enable_log_scale(ConvolverBox* self, GtkToggleButton* btn) {
   plot_fft(self);
 }
 
-void get_irs_spectrum(ConvolverBox* self, const int& rate) {
-  if (self->data->left_mag.empty() || self->data->right_mag.empty() ||
-      self->data->left_mag.size() != self->data->right_mag.size()) {
+void get_irs_spectrum(ConvolverBox* self,
+                      const int& rate,
+                      const std::vector<float>& kernel_L,
+                      const std::vector<float>& kernel_R) {
+  if (kernel_L.empty() || kernel_R.empty() || kernel_L.size() != kernel_R.size()) {
     util::debug(log_tag + " aborting the impulse fft calculation..."s);
 
     return;
@@ -172,10 +176,10 @@ void get_irs_spectrum(ConvolverBox* self, const int& rate) {
 
   util::debug(log_tag + " calculating the impulse fft..."s);
 
-  self->data->left_spectrum.resize(self->data->left_mag.size() / 2U + 1U);
-  self->data->right_spectrum.resize(self->data->right_mag.size() / 2U + 1U);
+  self->data->left_spectrum.resize(kernel_L.size() / 2U + 1U);
+  self->data->right_spectrum.resize(kernel_R.size() / 2U + 1U);
 
-  auto real_input = self->data->left_mag;
+  auto real_input = kernel_L;
 
   for (uint n = 0U; n < real_input.size(); n++) {
     // https://en.wikipedia.org/wiki/Hann_function
@@ -203,7 +207,7 @@ void get_irs_spectrum(ConvolverBox* self, const int& rate) {
 
   // right channel fft
 
-  real_input = self->data->right_mag;
+  real_input = kernel_R;
 
   for (uint n = 0U; n < real_input.size(); n++) {
     // https://en.wikipedia.org/wiki/Hann_function
@@ -346,80 +350,18 @@ void get_irs_info(ConvolverBox* self) {
 
   const float duration = (static_cast<float>(kernel_L.size()) - 1.0F) * dt;
 
-  self->data->time_axis.resize(kernel_L.size());
-
-  self->data->left_mag = kernel_L;
-  self->data->right_mag = kernel_R;
-
-  for (size_t n = 0; n < self->data->time_axis.size(); n++) {
-    self->data->time_axis[n] = static_cast<float>(n) * dt;
-  }
-
-  get_irs_spectrum(self, rate);
-
-  size_t bin_size = (gtk_widget_get_width(GTK_WIDGET(self->chart)) > 0)
-                        ? self->data->time_axis.size() / gtk_widget_get_width(GTK_WIDGET(self->chart))
-                        : 0;
+  get_irs_spectrum(self, rate, kernel_L, kernel_R);
 
-  if (bin_size > 0) {
-    // decimating the data so we can draw it
+  /*
+    The waveform is plotted from min/max pyramids built here, in this worker thread. The chart reads them at its
+    width, so the cost of drawing does not depend on the length of the impulse.
+  */
 
-    std::vector<float> t;
-    std::vector<float> l;
-    std::vector<float> r;
-    std::vector<float> bin_x;
-    std::vector<float> bin_l_y;
-    std::vector<float> bin_r_y;
+  auto left_waveform = std::make_shared<WaveformPyramid>();
+  auto right_waveform = std::make_shared<WaveformPyramid>();
 
-    for (size_t n = 0; n < self->data->time_axis.size(); n++) {
-      bin_x.push_back(self->data->time_axis[n]);
-
-      bin_l_y.push_back(self->data->left_mag[n]);
-      bin_r_y.push_back(self->data->right_mag[n]);
-
-      if (bin_x.size() == bin_size) {
-        const auto [min, max] = std::ranges::minmax_element(bin_l_y);
-
-        t.push_back(bin_x[min - bin_l_y.begin()]);
-        t.push_back(bin_x[max - bin_l_y.begin()]);
-
-        l.push_back(*min);
-        l.push_back(*max);
-
-        const auto [minr, maxr] = std::ranges::minmax_element(bin_r_y);
-
-        r.push_back(*minr);
-        r.push_back(*maxr);
-
-        bin_x.resize(0);
-        bin_l_y.resize(0);
-        bin_r_y.resize(0);
-      }
-    }
-
-    self->data->time_axis = t;
-    self->data->left_mag = l;
-    self->data->right_mag = r;
-  }
-
-  self->data->time_axis.shrink_to_fit();
-  self->data->left_mag.shrink_to_fit();
-  self->data->right_mag.shrink_to_fit();
-
-  // find min and max values
-
-  const auto min_left = std::ranges::min(self->data->left_mag);
-  const auto max_left = std::ranges::max(self->data->left_mag);
-
-  const auto min_right = std::ranges::min(self->data->right_mag);
-  const auto max_right = std::ranges::max(self->data->right_mag);
-
-  // rescaling between 0 and 1
-
-  for (size_t n = 0U; n < self->data->left_mag.size(); n++) {
-    self->data->left_mag[n] = (self->data->left_mag[n] - min_left) / (max_left - min_left);
-    self->data->right_mag[n] = (self->data->right_mag[n] - min_right) / (max_right - min_right);
-  }
+  left_waveform->build(kernel_L, dt);
+  right_waveform->build(kernel_R, dt);
 
   // updating interface with ir file info
 
@@ -427,6 +369,9 @@ void get_irs_info(ConvolverBox* self) {
   auto n_samples = kernel_L.size();
 
   util::idle_add([=]() {
+    self->data->left_waveform = left_waveform;
+    self->data->right_waveform = right_waveform;
+
     if (!ui::chart::get_is_visible(self->chart)) {
       return;
     }
@@ -459,15 +404,9 @@ void setup(ConvolverBox* self,
 
   ui::convolver_menu_impulses::setup(self->impulses_menu, schema_path, application);
 
-  self->data->connections.push_back(convolver->input_level.connect([=](const float& left, const float& right) {
-    update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                 self->input_level_right_label, left, right);
-  }));
-
-  self->data->connections.push_back(convolver->output_level.connect([=](const float& left, const float& right) {
-    update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                 self->output_level_right_label, left, right);
-  }));
+  add_level_meters_tick(GTK_WIDGET(self), convolver, self->input_level_left, self->input_level_left_label,
+                        self->input_level_right, self->input_level_right_label, self->output_level_left,
+                        self->output_level_left_label, self->output_level_right, self->output_level_right_label);
 
   self->data->gconnections.push_back(g_signal_connect(
       self->settings, "changed::kernel-path", G_CALLBACK(+[](GSettings* settings, char* key, ConvolverBox* self) {
@@ -483,6 +422,8 @@ void setup(ConvolverBox* self,
 
   g_settings_bind(self->settings, "ir-width", gtk_spin_button_get_adjustment(self->ir_width), "value",
                   G_SETTINGS_BIND_DEFAULT);
+
+  g_settings_bind(self->settings, "zero-latency", self->zero_latency, "active", G_SETTINGS_BIND_DEFAULT);
 }
 
 void dispose(GObject* object) {
@@ -561,6 +502,7 @@ void convolver_box_class_init(ConvolverBoxClass* klass) {
   gtk_widget_class_bind_template_child(widget_class, ConvolverBox, label_samples);
   gtk_widget_class_bind_template_child(widget_class, ConvolverBox, label_duration);
   gtk_widget_class_bind_template_child(widget_class, ConvolverBox, ir_width);
+  gtk_widget_class_bind_template_child(widget_class, ConvolverBox, zero_latency);
   gtk_widget_class_bind_template_child(widget_class, ConvolverBox, check_left);
   gtk_widget_class_bind_template_child(widget_class, ConvolverBox, check_right);
   gtk_widget_class_bind_template_child(widget_class, ConvolverBox, show_fft);
@@ -0,0 +1,338 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "convolver_worker_pool.hpp"
+
+ConvolverWorkerPool::ConvolverWorkerPool() : queue(queue_capacity) {
+  for (uint n = 0U; n < queue_capacity; n++) {
+    queue[n].sequence.store(n, std::memory_order_relaxed);
+  }
+}
+
+ConvolverWorkerPool::~ConvolverWorkerPool() {
+  std::scoped_lock<std::mutex> lock(threads_mutex);
+
+  stop_threads();
+}
+
+auto ConvolverWorkerPool::get() -> ConvolverWorkerPool& {
+  static ConvolverWorkerPool pool;
+
+  return pool;
+}
+
+void ConvolverWorkerPool::set_n_threads(const uint& value) {
+  std::scoped_lock<std::mutex> lock(threads_mutex);
+
+  n_threads = (value != 0U) ? value : std::max(1U, std::thread::hardware_concurrency() / 2U);
+
+  stop_threads();
+  start_threads();
+}
+
+void ConvolverWorkerPool::set_priority(const int& value) {
+  std::scoped_lock<std::mutex> lock(threads_mutex);
+
+  priority = value;
+
+  stop_threads();
+  start_threads();
+}
+
+void ConvolverWorkerPool::start_threads() {
+  stop = false;
+
+  priority_denied = false;
+
+  // The workers set their own priority before they take their first job
+
+  for (uint n = 0U; n < n_threads; n++) {
+    threads.emplace_back([this]() { worker(); });
+  }
+
+  util::debug(log_tag + "started " + util::to_string(n_threads) + " threads with minimum priority " +
+              util::to_string(priority.load()));
+}
+
+void ConvolverWorkerPool::apply_priority(int& applied_priority) {
+  const auto wanted = std::max(priority.load(), caller_priority.load());
+
+  if (wanted == applied_priority) {
+    return;
+  }
+
+  // It is not retried. A failure now would fail again for the next job.
+
+  applied_priority = wanted;
+
+  sched_param param{};
+
+  param.sched_priority = wanted;
+
+  if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+    if (!priority_denied.exchange(true)) {
+      util::warning(log_tag + "could not set the realtime priority " + util::to_string(wanted) +
+                    ". Realtime threads will run their convolution jobs themselves.");
+    }
+  }
+}
+
+void ConvolverWorkerPool::stop_threads() {
+  stop = true;
+
+  // Every worker takes one of these and leaves. The jobs still in the queue keep theirs for the next threads.
+
+  work_available.release(static_cast<std::ptrdiff_t>(threads.size()));
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  threads.clear();
+
+  if (jobs_done != 0U) {
+    util::debug(log_tag + "jobs done: " + util::to_string(jobs_done.load()) +
+                ", deadline misses: " + util::to_string(deadline_misses.load()) +
+                ", max queue depth: " + util::to_string(max_queue_size.load()));
+  }
+}
+
+/*
+  Bounded multiple producer and multiple consumer queue. Each slot has a sequence number that tells whether it is
+  free for the writer at a given position or holds a value for the reader at that position. Nobody waits on anybody:
+  a full queue makes push fail and an empty one makes pop return nullptr.
+*/
+
+auto ConvolverWorkerPool::push(Job* job) -> bool {
+  auto position = enqueue_position.load(std::memory_order_relaxed);
+
+  while (true) {
+    auto& slot = queue[position % queue_capacity];
+
+    const auto diff = static_cast<int>(slot.sequence.load(std::memory_order_acquire) - position);
+
+    if (diff == 0) {
+      if (enqueue_position.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed)) {
+        slot.job = job;
+
+        slot.sequence.store(position + 1U, std::memory_order_release);
+
+        return true;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      position = enqueue_position.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+auto ConvolverWorkerPool::pop() -> Job* {
+  auto position = dequeue_position.load(std::memory_order_relaxed);
+
+  while (true) {
+    auto& slot = queue[position % queue_capacity];
+
+    const auto diff = static_cast<int>(slot.sequence.load(std::memory_order_acquire) - (position + 1U));
+
+    if (diff == 0) {
+      if (dequeue_position.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed)) {
+        auto* job = slot.job;
+
+        slot.sequence.store(position + queue_capacity, std::memory_order_release);
+
+        return job;
+      }
+    } else if (diff < 0) {
+      return nullptr;
+    } else {
+      position = dequeue_position.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void ConvolverWorkerPool::submit(Job* job) {
+  job->state.store(JobState::queued, std::memory_order_release);
+
+  // Read once per thread. Jobs come from the PipeWire data threads, whose scheduling is set when they start.
+
+  static thread_local const int thread_priority = util::get_realtime_priority();
+
+  for (auto p = caller_priority.load(std::memory_order_relaxed); p < thread_priority;) {
+    if (caller_priority.compare_exchange_weak(p, thread_priority)) {
+      break;
+    }
+  }
+
+  if (thread_priority > 0 && priority_denied.load(std::memory_order_relaxed)) {
+    // waiting for a worker the scheduler may preempt could be worse than doing the work. wait() runs the job.
+
+    return;
+  }
+
+  job->n_entries.fetch_add(1U, std::memory_order_relaxed);
+
+  if (!push(job)) {
+    /*
+      This should never happen because each engine has at most one job in the queue. The job stays queued and the
+      realtime thread runs it when it calls wait().
+    */
+
+    job->n_entries.fetch_sub(1U, std::memory_order_relaxed);
+
+    return;
+  }
+
+  const auto size = queue_size.fetch_add(1U, std::memory_order_relaxed) + 1U;
+
+  if (size > max_queue_size.load(std::memory_order_relaxed)) {
+    max_queue_size.store(size, std::memory_order_relaxed);
+  }
+
+  work_available.release();
+}
+
+void ConvolverWorkerPool::wait(Job* job) {
+  auto expected = JobState::queued;
+
+  if (job->state.compare_exchange_strong(expected, JobState::running, std::memory_order_acquire)) {
+    // no worker took the job in time. We do it here
+
+    deadline_misses++;
+
+    run_job(job);
+  } else if (expected == JobState::running) {
+    const auto deadline = std::chrono::steady_clock::now() + wait_spin_duration;
+
+    while (job->state.load(std::memory_order_acquire) == JobState::running &&
+           std::chrono::steady_clock::now() < deadline) {
+      util::cpu_relax();
+    }
+
+    /*
+      The worker is taking long. Sleep until run_job wakes us up instead of burning the cpu. The worker has at least
+      our priority, so nothing that we would preempt can keep it from finishing.
+    */
+
+    if (job->state.load(std::memory_order_acquire) == JobState::running) {
+      deadline_misses++;
+    }
+
+    while (job->state.load(std::memory_order_acquire) == JobState::running) {
+      job->state.wait(JobState::running, std::memory_order_acquire);
+    }
+  }
+
+  job->state.store(JobState::idle, std::memory_order_relaxed);
+}
+
+void ConvolverWorkerPool::cancel(Job* job) {
+  // the entries that are still in the queue will be skipped
+
+  auto expected = JobState::queued;
+
+  job->state.compare_exchange_strong(expected, JobState::idle, std::memory_order_acquire);
+
+  /*
+    Wait until no worker holds the job anymore. There may be no threads to drain the queue, so we help. Other jobs we
+    pop are run here as a worker would do.
+  */
+
+  while (job->n_entries.load(std::memory_order_acquire) != 0U) {
+    if (auto* entry = pop(); entry != nullptr) {
+      process_entry(entry);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  job->state.store(JobState::idle, std::memory_order_relaxed);
+}
+
+void ConvolverWorkerPool::process_entry(Job* job) {
+  queue_size.fetch_sub(1U, std::memory_order_relaxed);
+
+  /*
+    The job may have been cancelled or the realtime thread may have taken it already. In both cases there is nothing
+    to do. It may also have been submitted again after this entry was queued, and then it does not matter which entry
+    runs it.
+  */
+
+  auto expected = JobState::queued;
+
+  if (job->state.compare_exchange_strong(expected, JobState::running, std::memory_order_acquire)) {
+    run_job(job);
+  }
+
+  // after this the job may be destroyed
+
+  job->n_entries.fetch_sub(1U, std::memory_order_release);
+}
+
+void ConvolverWorkerPool::run_job(Job* job) {
+  job->run();
+
+  jobs_done++;
+
+  job->state.store(JobState::done, std::memory_order_release);
+
+  job->state.notify_one();
+}
+
+void ConvolverWorkerPool::worker() {
+  int applied_priority = 0;  // a new thread uses the default scheduler
+
+  while (true) {
+    work_available.acquire();
+
+    if (stop.load()) {
+      return;
+    }
+
+    // submit() raised caller_priority before it released the semaphore
+
+    apply_priority(applied_priority);
+
+    // cancel() may have taken the entry this permit was for
+
+    if (auto* job = pop(); job != nullptr) {
+      process_entry(job);
+    }
+  }
+}
+
+auto ConvolverWorkerPool::get_n_threads() const -> uint {
+  return n_threads;
+}
+
+auto ConvolverWorkerPool::get_queue_depth() const -> uint {
+  return queue_size;
+}
+
+auto ConvolverWorkerPool::get_max_queue_depth() const -> uint {
+  return max_queue_size;
+}
+
+auto ConvolverWorkerPool::get_deadline_misses() const -> uint64_t {
+  return deadline_misses;
+}
+
+auto ConvolverWorkerPool::get_jobs_done() const -> uint64_t {
+  return jobs_done;
+}
@@ -23,16 +23,11 @@ Crystalizer::Crystalizer(const std::string& tag,
                          const std::string& schema,
                          const std::string& schema_path,
                          PipeManager* pipe_manager)
-    : PluginBase(tag, plugin_name::crystalizer, schema, schema_path, pipe_manager) {
-  for (uint n = 0U; n < nbands; n++) {
-    filters.at(n) = std::make_unique<FirFilterBandpass>(log_tag + name + " band" + util::to_string(n));
-  }
-
+    : PluginBase(tag, plugin_name::crystalizer, schema, schema_path, pipe_manager),
+      filter_bank(std::make_unique<FirFilterBank>(log_tag + name + " ", nbands)) {
   std::ranges::fill(band_mute, false);
   std::ranges::fill(band_bypass, false);
   std::ranges::fill(band_intensity, 1.0F);
-  std::ranges::fill(band_last_L, 0.0F);
-  std::ranges::fill(band_last_R, 0.0F);
 
   frequencies[0] = 20.0F;
   frequencies[1] = 520.0F;
@@ -78,9 +73,9 @@ void Crystalizer::setup() {
   data_mutex.unlock();
 
   /*
-    As zita uses fftw we have to be careful when reinitializing it. The thread that creates the fftw plan has to be the
-    same that destroys it. Otherwise segmentation faults can happen. As we do not want to do this initializing in the
-    plugin realtime thread we send it to the main thread through g_idle_add().connect_once
+    The filter bank uses fftw and we have to be careful when reinitializing it. The thread that creates the fftw plan has
+    to be the same that destroys it. Otherwise segmentation faults can happen. As we do not want to do this initializing
+    in the plugin realtime thread we send it to the main thread through g_idle_add().connect_once
   */
 
   util::idle_add([&, this] {
@@ -101,7 +96,6 @@ void Crystalizer::setup() {
     util::debug(log_tag + name + " blocksize: " + util::to_string(blocksize));
 
     notify_latency = true;
-    do_first_rotation = true;
 
     latency_n_frames = 1U;  // the second derivative forces us to delay at least one sample
 
@@ -111,27 +105,31 @@ void Crystalizer::setup() {
     data_L.resize(0);
     data_R.resize(0);
 
-    for (uint n = 0U; n < nbands; n++) {
-      band_data_L.at(n).resize(blocksize);
-      band_data_R.at(n).resize(blocksize);
+    band_stride = band_history + blocksize;
 
-      band_second_derivative_L.at(n).resize(blocksize);
-      band_second_derivative_R.at(n).resize(blocksize);
-    }
+    band_data_L.resize(nbands * band_stride);
+    band_data_R.resize(nbands * band_stride);
 
-    for (uint n = 0U; n < nbands; n++) {
-      filters.at(n)->set_n_samples(blocksize);
-      filters.at(n)->set_rate(rate);
+    bypass_data_L.resize(1U + blocksize);
+    bypass_data_R.resize(1U + blocksize);
+
+    std::ranges::fill(band_data_L, 0.0F);
+    std::ranges::fill(band_data_R, 0.0F);
+    std::ranges::fill(bypass_data_L, 0.0F);
+    std::ranges::fill(bypass_data_R, 0.0F);
 
-      filters.at(n)->set_min_frequency(frequencies.at(n));
-      filters.at(n)->set_max_frequency(frequencies.at(n + 1U));
+    filter_bank->set_n_samples(blocksize);
+    filter_bank->set_rate(rate);
 
-      filters.at(n)->setup();
+    for (uint n = 0U; n < nbands; n++) {
+      filter_bank->set_band_frequencies(n, frequencies.at(n), frequencies.at(n + 1U));
     }
 
+    filter_bank->setup();
+
     data_mutex.lock();
 
-    filters_are_ready = true;
+    filters_are_ready = filter_bank->is_ready();
 
     data_mutex.unlock();
   });
@@ -283,8 +281,8 @@ void Crystalizer::bind_band(const int& n) {
                                             if (util::str_to_num(s_key.substr(s_key.find("-band") + 5), index)) {
                                               auto self = static_cast<Crystalizer*>(user_data);
 
-                                              self->band_intensity.at(index) =
-                                                  g_settings_get_double(settings, key) != 0;
+                                              self->band_intensity.at(index) = static_cast<float>(
+                                                  util::db_to_linear(g_settings_get_double(settings, key)));
                                             }
                                           }),
                                           this));
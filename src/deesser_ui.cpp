@@ -82,15 +82,9 @@ void setup(DeesserBox* self, std::shared_ptr<Deesser> deesser, const std::string
   deesser->post_messages = true;
   deesser->bypass = false;
 
-  self->data->connections.push_back(deesser->input_level.connect([=](const float& left, const float& right) {
-    update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                 self->input_level_right_label, left, right);
-  }));
-
-  self->data->connections.push_back(deesser->output_level.connect([=](const float& left, const float& right) {
-    update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                 self->output_level_right_label, left, right);
-  }));
+  add_level_meters_tick(GTK_WIDGET(self), deesser, self->input_level_left, self->input_level_left_label,
+                        self->input_level_right, self->input_level_right_label, self->output_level_left,
+                        self->output_level_left_label, self->output_level_right, self->output_level_right_label);
 
   self->data->connections.push_back(deesser->detected.connect([=](const double& value) {
     gtk_level_bar_set_value(self->compression, 1.0 - value);
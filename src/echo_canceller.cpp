@@ -19,6 +19,31 @@
 
 #include "echo_canceller.hpp"
 
+namespace {
+
+/*
+  Plain loops over contiguous memory without branches so that the compiler can vectorize them. Clamping also keeps
+  full scale input from wrapping around when it is converted to 16 bits.
+*/
+
+void to_s16(const float* in, spx_int16_t* out, const size_t& n_frames) {
+  constexpr float scale = SHRT_MAX + 1;
+
+  for (size_t n = 0U; n < n_frames; n++) {
+    out[n] = static_cast<spx_int16_t>(std::clamp(in[n] * scale, -scale, scale - 1.0F));
+  }
+}
+
+void from_s16(const spx_int16_t* in, float* out, const size_t& n_frames) {
+  constexpr float inv_scale = 1.0F / (SHRT_MAX + 1);
+
+  for (size_t n = 0U; n < n_frames; n++) {
+    out[n] = static_cast<float>(in[n]) * inv_scale;
+  }
+}
+
+}  // namespace
+
 EchoCanceller::EchoCanceller(const std::string& tag,
                              const std::string& schema,
                              const std::string& schema_path,
@@ -48,6 +73,26 @@ EchoCanceller::EchoCanceller(const std::string& tag,
                                           }),
                                           this));
 
+  gconnections.push_back(g_signal_connect(settings, "changed::automatic-delay",
+                                          G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                                            auto self = static_cast<EchoCanceller*>(user_data);
+
+                                            const auto value = g_settings_get_boolean(settings, key) != 0;
+
+                                            self->delay_estimator.set_enabled(value);
+
+                                            std::scoped_lock<std::mutex> lock(self->data_mutex);
+
+                                            self->automatic_delay = value;
+
+                                            self->probe_delay_n_frames = 0U;
+                                          }),
+                                          this));
+
+  automatic_delay = g_settings_get_boolean(settings, "automatic-delay") != 0;
+
+  delay_estimator.set_enabled(automatic_delay);
+
   setup_input_output_gain();
 }
 
@@ -82,8 +127,13 @@ void EchoCanceller::setup() {
 
   latency_n_frames = 0U;
 
-  deque_out_L.resize(0);
-  deque_out_R.resize(0);
+  probe_delay_n_frames = 0U;
+  probe_delay_write = 0U;
+
+  probe_delay_L.assign(static_cast<size_t>(EchoDelayEstimator::max_delay_seconds * rate) + n_samples, 0.0F);
+  probe_delay_R.assign(probe_delay_L.size(), 0.0F);
+
+  delay_estimator.set_rate(rate, n_samples);
 
   init_speex();
 }
@@ -107,69 +157,63 @@ void EchoCanceller::process(std::span<float>& left_in,
     apply_gain(left_in, right_in, input_gain);
   }
 
-  for (size_t j = 0U; j < left_in.size(); j++) {
-    data_L.push_back(left_in[j] * (SHRT_MAX + 1));
-    data_R.push_back(right_in[j] * (SHRT_MAX + 1));
+  if (automatic_delay) {
+    delay_estimator.push(left_in, right_in, probe_left, probe_right);
 
-    probe_L.push_back(probe_left[j] * (SHRT_MAX + 1));
-    probe_R.push_back(probe_right[j] * (SHRT_MAX + 1));
+    update_probe_delay();
 
-    if (data_L.size() == blocksize) {
-      speex_echo_cancellation(echo_state_L, data_L.data(), probe_L.data(), filtered_L.data());
-      speex_echo_cancellation(echo_state_R, data_R.data(), probe_R.data(), filtered_R.data());
+    delay_probe(probe_left, probe_right);
+  }
 
-      for (const auto& v : filtered_L) {
-        deque_out_L.push_back(static_cast<float>(v) * inv_short_max);
-      }
+  for (size_t j = 0U; j < left_in.size();) {
+    const auto n_chunk = std::min(static_cast<size_t>(blocksize - block_fill), left_in.size() - j);
 
-      for (const auto& v : filtered_R) {
-        deque_out_R.push_back(static_cast<float>(v) * inv_short_max);
-      }
+    to_s16(left_in.data() + j, data_L.data() + block_fill, n_chunk);
+    to_s16(right_in.data() + j, data_R.data() + block_fill, n_chunk);
+    to_s16(probe_left.data() + j, probe_L.data() + block_fill, n_chunk);
+    to_s16(probe_right.data() + j, probe_R.data() + block_fill, n_chunk);
 
-      data_L.resize(0);
-      data_R.resize(0);
-      probe_L.resize(0);
-      probe_R.resize(0);
-    }
-  }
+    block_fill += n_chunk;
+    j += n_chunk;
 
-  // copying the processed samples to the output buffers
+    if (block_fill == blocksize) {
+      ForkJoin::get().run(
+          [&] {
+            speex_echo_cancellation(echo_state_L, data_L.data(), probe_L.data(), filtered_s16_L.data());
 
-  if (deque_out_L.size() >= left_out.size()) {
-    for (float& v : left_out) {
-      v = deque_out_L.front();
+            from_s16(filtered_s16_L.data(), filtered_L.data(), blocksize);
+          },
+          [&] {
+            speex_echo_cancellation(echo_state_R, data_R.data(), probe_R.data(), filtered_s16_R.data());
 
-      deque_out_L.pop_front();
-    }
+            from_s16(filtered_s16_R.data(), filtered_R.data(), blocksize);
+          });
 
-    for (float& v : right_out) {
-      v = deque_out_R.front();
+      ring_out_L.push(filtered_L);
+      ring_out_R.push(filtered_R);
 
-      deque_out_R.pop_front();
+      block_fill = 0U;
     }
-  } else {
-    const uint offset = left_out.size() - deque_out_L.size();
+  }
 
-    if (offset != latency_n_frames) {
-      latency_n_frames = offset;
+  // copying the processed samples to the output buffers
 
-      notify_latency = true;
-    }
+  const auto n_available = ring_out_L.read_available();
 
-    for (uint n = 0U; !deque_out_L.empty() && n < left_out.size(); n++) {
-      if (n < offset) {
-        left_out[n] = 0.0F;
-        right_out[n] = 0.0F;
-      } else {
-        left_out[n] = deque_out_L.front();
-        right_out[n] = deque_out_R.front();
+  const auto offset = (n_available < left_out.size()) ? left_out.size() - n_available : 0U;
 
-        deque_out_R.pop_front();
-        deque_out_L.pop_front();
-      }
-    }
+  if (offset != 0U && offset != latency_n_frames) {
+    latency_n_frames = offset;
+
+    notify_latency = true;
   }
 
+  std::fill(left_out.begin(), left_out.begin() + offset, 0.0F);
+  std::fill(right_out.begin(), right_out.begin() + offset, 0.0F);
+
+  ring_out_L.pop(left_out.subspan(offset));
+  ring_out_R.pop(right_out.subspan(offset));
+
   if (output_gain != 1.0F) {
     apply_gain(left_out, right_out, output_gain);
   }
@@ -222,43 +266,100 @@ void EchoCanceller::init_speex() {
     return;
   }
 
-  data_L.resize(0);
-  data_R.resize(0);
-  probe_L.resize(0);
-  probe_R.resize(0);
-
   blocksize = 0.001F * blocksize_ms * rate;
 
   util::debug(log_tag + name + " blocksize: " + util::to_string(blocksize));
 
+  block_fill = 0U;
+
+  data_L.resize(blocksize);
+  data_R.resize(blocksize);
+  probe_L.resize(blocksize);
+  probe_R.resize(blocksize);
+  filtered_s16_L.resize(blocksize);
+  filtered_s16_R.resize(blocksize);
+
   filtered_L.resize(blocksize);
   filtered_R.resize(blocksize);
 
+  // One block plus one quantum is the most the output rings can hold before process() drains them
+
+  ring_out_L.resize(blocksize + n_samples);
+  ring_out_R.resize(blocksize + n_samples);
+
   const uint filter_length = 0.001F * filter_length_ms * rate;
 
   util::debug(log_tag + name + " filter length: " + util::to_string(filter_length));
 
-  if (echo_state_L != nullptr) {
-    speex_echo_state_destroy(echo_state_L);
-  }
+  for (auto* state : {&echo_state_L, &echo_state_R}) {
+    if (*state != nullptr) {
+      speex_echo_state_destroy(*state);
+    }
 
-  echo_state_L = speex_echo_state_init(blocksize, filter_length);
+    *state = speex_echo_state_init(blocksize, filter_length);
 
-  if (speex_echo_ctl(echo_state_L, SPEEX_ECHO_SET_SAMPLING_RATE, &rate) != 0) {
-    util::warning(log_tag + name + "SPEEX_ECHO_SET_SAMPLING_RATE: unknown request");
+    if (speex_echo_ctl(*state, SPEEX_ECHO_SET_SAMPLING_RATE, &rate) != 0) {
+      util::warning(log_tag + name + "SPEEX_ECHO_SET_SAMPLING_RATE: unknown request");
+    }
   }
 
-  if (echo_state_R != nullptr) {
-    speex_echo_state_destroy(echo_state_R);
+  ready = true;
+}
+
+void EchoCanceller::update_probe_delay() {
+  const auto estimate = delay_estimator.get_delay_frames();
+
+  if (estimate < 0) {
+    return;
   }
 
-  echo_state_R = speex_echo_state_init(blocksize, filter_length);
+  const auto margin = static_cast<int>(probe_delay_margin * static_cast<float>(rate));
 
-  if (speex_echo_ctl(echo_state_R, SPEEX_ECHO_SET_SAMPLING_RATE, &rate) != 0) {
-    util::warning(log_tag + name + "SPEEX_ECHO_SET_SAMPLING_RATE: unknown request");
+  const auto max_delay = static_cast<int>(probe_delay_L.size() - n_samples);
+
+  const auto value = static_cast<uint>(std::clamp(estimate - margin, 0, max_delay));
+
+  // Changes smaller than a millisecond are left for the adaptive filter to follow
+
+  if (std::abs(static_cast<int>(value) - static_cast<int>(probe_delay_n_frames)) * 1000 < static_cast<int>(rate)) {
+    return;
   }
 
-  ready = true;
+  probe_delay_n_frames = value;
+
+  // The echo path as seen by the filter has changed. What it learned so far is no longer valid.
+
+  speex_echo_state_reset(echo_state_L);
+  speex_echo_state_reset(echo_state_R);
+
+  const auto delay_seconds = static_cast<float>(probe_delay_n_frames) / static_cast<float>(rate);
+
+  util::debug(log_tag + name + " probe delay: " + util::to_string(delay_seconds, "") + " s");
+
+  util::idle_add([=, this]() {
+    if (!post_messages) {
+      return;
+    }
+
+    probe_delay.emit(delay_seconds);
+  });
+}
+
+void EchoCanceller::delay_probe(std::span<float>& probe_left, std::span<float>& probe_right) {
+  const auto size = static_cast<uint>(probe_delay_L.size());
+
+  auto read = (probe_delay_write + size - probe_delay_n_frames) % size;
+
+  for (size_t n = 0U; n < probe_left.size(); n++) {
+    probe_delay_L[probe_delay_write] = probe_left[n];
+    probe_delay_R[probe_delay_write] = probe_right[n];
+
+    probe_left[n] = probe_delay_L[read];
+    probe_right[n] = probe_delay_R[read];
+
+    probe_delay_write = (probe_delay_write + 1U == size) ? 0U : probe_delay_write + 1U;
+    read = (read + 1U == size) ? 0U : read + 1U;
+  }
 }
 
 auto EchoCanceller::get_latency_seconds() -> float {
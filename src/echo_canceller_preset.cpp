@@ -33,6 +33,8 @@ void EchoCancellerPreset::save(nlohmann::json& json, const std::string& section,
   json[section]["echo_canceller"]["frame-size"] = g_settings_get_int(settings, "frame-size");
 
   json[section]["echo_canceller"]["filter-length"] = g_settings_get_int(settings, "filter-length");
+
+  json[section]["echo_canceller"]["automatic-delay"] = g_settings_get_boolean(settings, "automatic-delay") != 0;
 }
 
 void EchoCancellerPreset::load(const nlohmann::json& json, const std::string& section, GSettings* settings) {
@@ -43,4 +45,6 @@ void EchoCancellerPreset::load(const nlohmann::json& json, const std::string& se
   update_key<int>(json.at(section).at("echo_canceller"), settings, "frame-size", "frame-size");
 
   update_key<int>(json.at(section).at("echo_canceller"), settings, "filter-length", "filter-length");
+
+  update_key<bool>(json.at(section).at("echo_canceller"), settings, "automatic-delay", "automatic-delay");
 }
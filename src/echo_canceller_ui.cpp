@@ -49,6 +49,10 @@ struct _EchoCancellerBox {
 
   GtkSpinButton *frame_size, *filter_length;
 
+  GtkToggleButton* automatic_delay;
+
+  GtkLabel* probe_delay;
+
   GSettings* settings;
 
   Data* data;
@@ -74,14 +78,12 @@ void setup(EchoCancellerBox* self, std::shared_ptr<EchoCanceller> echo_canceller
   echo_canceller->post_messages = true;
   echo_canceller->bypass = false;
 
-  self->data->connections.push_back(echo_canceller->input_level.connect([=](const float& left, const float& right) {
-    update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                 self->input_level_right_label, left, right);
-  }));
+  add_level_meters_tick(GTK_WIDGET(self), echo_canceller, self->input_level_left, self->input_level_left_label,
+                        self->input_level_right, self->input_level_right_label, self->output_level_left,
+                        self->output_level_left_label, self->output_level_right, self->output_level_right_label);
 
-  self->data->connections.push_back(echo_canceller->output_level.connect([=](const float& left, const float& right) {
-    update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                 self->output_level_right_label, left, right);
+  self->data->connections.push_back(echo_canceller->probe_delay.connect([=](const float& value) {
+    gtk_label_set_text(self->probe_delay, fmt::format("{0:.1f} ms", 1000.0F * value).c_str());
   }));
 
   gsettings_bind_widgets<"input-gain", "output-gain">(self->settings, self->input_gain, self->output_gain);
@@ -91,6 +93,8 @@ void setup(EchoCancellerBox* self, std::shared_ptr<EchoCanceller> echo_canceller
 
   g_settings_bind(self->settings, "filter-length", gtk_spin_button_get_adjustment(self->filter_length), "value",
                   G_SETTINGS_BIND_DEFAULT);
+
+  g_settings_bind(self->settings, "automatic-delay", self->automatic_delay, "active", G_SETTINGS_BIND_DEFAULT);
 }
 
 void dispose(GObject* object) {
@@ -150,6 +154,8 @@ void echo_canceller_box_class_init(EchoCancellerBoxClass* klass) {
 
   gtk_widget_class_bind_template_child(widget_class, EchoCancellerBox, frame_size);
   gtk_widget_class_bind_template_child(widget_class, EchoCancellerBox, filter_length);
+  gtk_widget_class_bind_template_child(widget_class, EchoCancellerBox, automatic_delay);
+  gtk_widget_class_bind_template_child(widget_class, EchoCancellerBox, probe_delay);
 
   gtk_widget_class_bind_template_callback(widget_class, on_bypass);
   gtk_widget_class_bind_template_callback(widget_class, on_reset);
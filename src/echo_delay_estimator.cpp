@@ -0,0 +1,284 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "echo_delay_estimator.hpp"
+
+EchoDelayEstimator::EchoDelayEstimator() : near_segment(segment_size), far_segment(segment_size) {
+  ring_near.resize(2U * segment_size);
+  ring_far.resize(2U * segment_size);
+
+  time_data = fftwf_alloc_real(fft_size);
+  correlation = fftwf_alloc_real(fft_size);
+
+  near_spectrum = fftwf_alloc_complex(n_bins);
+  far_spectrum = fftwf_alloc_complex(n_bins);
+  average = fftwf_alloc_complex(n_bins);
+
+  // fftw planning is not thread safe. The plans are made here and only executed by the worker.
+
+  forward_plan = fftwf_plan_dft_r2c_1d(static_cast<int>(fft_size), time_data, near_spectrum, FFTW_ESTIMATE);
+  backward_plan = fftwf_plan_dft_c2r_1d(static_cast<int>(fft_size), average, correlation, FFTW_ESTIMATE);
+
+  reset_worker_state();
+}
+
+EchoDelayEstimator::~EchoDelayEstimator() {
+  set_enabled(false);
+
+  fftwf_destroy_plan(forward_plan);
+  fftwf_destroy_plan(backward_plan);
+
+  fftwf_free(time_data);
+  fftwf_free(correlation);
+  fftwf_free(near_spectrum);
+  fftwf_free(far_spectrum);
+  fftwf_free(average);
+}
+
+void EchoDelayEstimator::set_enabled(const bool& value) {
+  if (value == worker.joinable()) {
+    return;
+  }
+
+  if (value) {
+    quit = false;
+
+    worker = std::thread([this]() { work(); });
+
+    enabled = true;
+
+    util::debug(log_tag + "started");
+
+    return;
+  }
+
+  enabled = false;
+
+  {
+    std::scoped_lock<std::mutex> lock(worker_mutex);
+
+    quit = true;
+  }
+
+  worker_cv.notify_one();
+
+  worker.join();
+
+  delay.store(-1);
+
+  util::debug(log_tag + "stopped");
+}
+
+void EchoDelayEstimator::set_rate(const uint& rate, const uint& n_samples) {
+  decimation = std::max(1U, rate / target_rate);
+  decimation_count = 0U;
+
+  near_sum = 0.0F;
+  far_sum = 0.0F;
+
+  near_decimated.resize(n_samples / decimation + 1U);
+  far_decimated.resize(n_samples / decimation + 1U);
+
+  const auto decimated_rate = static_cast<float>(rate) / static_cast<float>(decimation);
+
+  max_lag.store(std::min(static_cast<uint>(max_delay_seconds * decimated_rate), segment_size / 2U));
+
+  /*
+    The rings are not reset here because the worker may be reading them. The new generation makes it throw away
+    what it had so far, and the few samples left from the old rate do not matter.
+  */
+
+  delay.store(-1);
+
+  generation++;
+}
+
+void EchoDelayEstimator::push(std::span<const float> left_in,
+                              std::span<const float> right_in,
+                              std::span<const float> probe_left,
+                              std::span<const float> probe_right) {
+  if (!enabled || near_decimated.empty()) {
+    return;
+  }
+
+  // Averaging groups of samples is a crude anti aliasing filter but it is enough for finding the correlation peak
+
+  const float scale = 0.5F / static_cast<float>(decimation);
+
+  size_t n_out = 0U;
+
+  for (size_t n = 0U; n < left_in.size(); n++) {
+    near_sum += left_in[n] + right_in[n];
+    far_sum += probe_left[n] + probe_right[n];
+
+    if (++decimation_count == decimation) {
+      near_decimated[n_out] = near_sum * scale;
+      far_decimated[n_out] = far_sum * scale;
+
+      n_out++;
+
+      decimation_count = 0U;
+
+      near_sum = 0.0F;
+      far_sum = 0.0F;
+    }
+  }
+
+  // Both rings are only pushed together so that they always stay aligned
+
+  if (ring_near.write_available() >= n_out && ring_far.write_available() >= n_out) {
+    ring_near.push(std::span<const float>(near_decimated.data(), n_out));
+    ring_far.push(std::span<const float>(far_decimated.data(), n_out));
+  }
+}
+
+auto EchoDelayEstimator::get_delay_frames() const -> int {
+  const auto value = delay.load(std::memory_order_relaxed);
+
+  return (value < 0) ? -1 : value * static_cast<int>(decimation);
+}
+
+void EchoDelayEstimator::reset_worker_state() {
+  for (uint n = 0U; n < n_bins; n++) {
+    average[n][0] = 0.0F;
+    average[n][1] = 0.0F;
+  }
+
+  confirmations = 0U;
+  candidate = -1;
+}
+
+void EchoDelayEstimator::work() {
+  std::unique_lock<std::mutex> lock(worker_mutex);
+
+  while (!quit) {
+    worker_cv.wait_for(lock, std::chrono::milliseconds(200), [this]() { return quit; });
+
+    if (quit) {
+      break;
+    }
+
+    if (const auto g = generation.load(); g != worker_generation) {
+      worker_generation = g;
+
+      reset_worker_state();
+    }
+
+    while (ring_near.read_available() >= segment_size && ring_far.read_available() >= segment_size) {
+      ring_near.pop(near_segment);
+      ring_far.pop(far_segment);
+
+      const auto lag = estimate();
+
+      if (lag < 0) {
+        continue;
+      }
+
+      // A couple of samples of jitter at 8 kHz is well below what the adaptive filter can absorb
+
+      if (candidate >= 0 && std::abs(lag - candidate) <= 2) {
+        confirmations++;
+      } else {
+        candidate = lag;
+        confirmations = 1U;
+      }
+
+      if (confirmations >= n_confirmations && candidate != delay.load()) {
+        delay.store(candidate);
+
+        util::debug(log_tag + "estimated delay: " + util::to_string(candidate) + " decimated samples");
+      }
+    }
+  }
+}
+
+auto EchoDelayEstimator::estimate() -> int {
+  double probe_energy = 0.0;
+
+  for (const auto& v : far_segment) {
+    probe_energy += static_cast<double>(v) * static_cast<double>(v);
+  }
+
+  // Nothing is being played. There is no echo to measure.
+
+  if (std::sqrt(probe_energy / segment_size) < min_probe_rms) {
+    return -1;
+  }
+
+  std::fill(time_data + segment_size, time_data + fft_size, 0.0F);
+
+  std::copy(near_segment.begin(), near_segment.end(), time_data);
+
+  fftwf_execute_dft_r2c(forward_plan, time_data, near_spectrum);
+
+  std::copy(far_segment.begin(), far_segment.end(), time_data);
+
+  fftwf_execute_dft_r2c(forward_plan, time_data, far_spectrum);
+
+  /*
+    Near times the conjugate of far, normalized to unit magnitude (PHAT weighting) so that the peak does not depend
+    on the spectrum of the signal. It is averaged over the last segments to be robust against short noisy ones.
+  */
+
+  constexpr float smoothing = 0.5F;
+
+  for (uint n = 0U; n < n_bins; n++) {
+    const float re = near_spectrum[n][0] * far_spectrum[n][0] + near_spectrum[n][1] * far_spectrum[n][1];
+    const float im = near_spectrum[n][1] * far_spectrum[n][0] - near_spectrum[n][0] * far_spectrum[n][1];
+
+    const float magnitude = std::sqrt(re * re + im * im) + 1e-12F;
+
+    average[n][0] = (1.0F - smoothing) * average[n][0] + smoothing * re / magnitude;
+    average[n][1] = (1.0F - smoothing) * average[n][1] + smoothing * im / magnitude;
+  }
+
+  // The backward transform would overwrite its input, so it works on a copy
+
+  std::copy_n(&average[0][0], 2U * n_bins, &far_spectrum[0][0]);
+
+  fftwf_execute_dft_c2r(backward_plan, far_spectrum, correlation);
+
+  // Positive lags mean the microphone hears the probe later. Those are the only ones that make physical sense.
+
+  const auto n_lags = max_lag.load() + 1U;
+
+  float peak = 0.0F;
+  float sum = 0.0F;
+
+  int peak_lag = -1;
+
+  for (uint k = 0U; k < n_lags; k++) {
+    const float v = std::fabs(correlation[k]);
+
+    sum += v;
+
+    if (v > peak) {
+      peak = v;
+      peak_lag = static_cast<int>(k);
+    }
+  }
+
+  const float mean = sum / static_cast<float>(n_lags);
+
+  if (mean <= 0.0F || peak < min_peak_ratio * mean) {
+    return -1;
+  }
+
+  return peak_lag;
+}
@@ -185,6 +185,94 @@ void EffectsBase::deactivate_filters() {
   }
 }
 
+auto EffectsBase::add_pipeline_edge(std::vector<PipelineEdge>& edges,
+                                    const uint& output_node_id,
+                                    const uint& input_node_id,
+                                    const bool& probe) -> uint {
+  const auto n_links = static_cast<uint>(pm->match_ports(output_node_id, input_node_id, probe).size());
+
+  if (n_links != 0U) {
+    edges.push_back({output_node_id, input_node_id, probe});
+  }
+
+  return n_links;
+}
+
+void EffectsBase::update_pipeline_links(const std::vector<PipelineEdge>& edges) {
+  LinkTransaction transaction(pm);
+
+  // Node ids are reused by PipeWire, so an edge we know about only counts if the graph still has its links
+
+  const auto edge_is_alive = [&](const PipelineEdge& edge) {
+    return std::ranges::any_of(pm->get_node_links(edge.output_node_id),
+                               [&](const auto& link) { return link.input_node_id == edge.input_node_id; });
+  };
+
+  uint n_kept = 0U;
+
+  std::vector<PipelineEdge> new_edges;
+
+  for (const auto& edge : edges) {
+    auto it = pipeline_links.find(edge);
+
+    if (it != pipeline_links.end()) {
+      if (edge_is_alive(edge)) {
+        n_kept++;
+
+        continue;
+      }
+
+      transaction.destroy_links(it->second);
+
+      it->second.clear();
+    }
+
+    transaction.link_nodes(edge.output_node_id, edge.input_node_id, pipeline_links[edge], edge.probe);
+
+    new_edges.push_back(edge);
+  }
+
+  // See the header for why some old edges have to go before the new ones are created
+
+  const auto conflicts_with_new_edge = [&](const PipelineEdge& old_edge) {
+    return std::ranges::any_of(new_edges, [&](const auto& edge) {
+      return (edge.input_node_id == old_edge.input_node_id && edge.probe == old_edge.probe) ||
+             (edge.input_node_id == old_edge.output_node_id && edge.output_node_id == old_edge.input_node_id);
+    });
+  };
+
+  for (auto it = pipeline_links.begin(); it != pipeline_links.end();) {
+    if (std::ranges::find(edges, it->first) == edges.end()) {
+      if (conflicts_with_new_edge(it->first)) {
+        transaction.destroy_links_first(it->second);
+      } else {
+        transaction.destroy_links(it->second);
+      }
+
+      it = pipeline_links.erase(it);
+    } else {
+      it++;
+    }
+  }
+
+  util::debug(log_tag + "keeping " + util::to_string(n_kept) + " of " + util::to_string(edges.size()) +
+              " pipeline edges");
+
+  transaction.commit();
+}
+
+void EffectsBase::disconnect_unused_plugins(const std::vector<std::string>& selected_plugins) {
+  for (const auto& plugin : plugins | std::views::values) {
+    if (plugin->connected_to_pw) {
+      if (std::ranges::find(selected_plugins, plugin->name) == selected_plugins.end()) {
+        util::debug(log_tag + "disconnecting the " + plugin->name + " filter from PipeWire");
+
+        plugin->disconnect_from_pw();
+      }
+    }
+  }
+}
+
 auto EffectsBase::get_pipeline_latency() -> float {
   float total = 0.0F;
 
@@ -37,13 +37,11 @@ struct Data {
 
   bool schedule_signal_idle;
 
-  uint spectrum_rate, spectrum_n_bands;
+  uint spectrum_axis_serial;
 
-  float global_output_level_left, global_output_level_right, pipeline_latency_ms;
+  float pipeline_latency_ms;
 
-  std::vector<float> spectrum_mag, spectrum_freqs, spectrum_x_axis;
-
-  std::vector<uint> spectrum_bin_count;
+  Spectrum::Frame spectrum_frame;
 
   std::vector<sigc::connection> connections;
 
@@ -84,38 +82,8 @@ struct _EffectsBox {
 
 G_DEFINE_TYPE(EffectsBox, effects_box, GTK_TYPE_BOX)
 
-void init_spectrum_frequency_axis(EffectsBox* self) {
-  self->data->spectrum_freqs.resize(self->data->spectrum_n_bands);
-
-  for (uint n = 0U; n < self->data->spectrum_n_bands; n++) {
-    self->data->spectrum_freqs[n] = 0.5F * static_cast<float>(self->data->spectrum_rate) * static_cast<float>(n) /
-                                    static_cast<float>(self->data->spectrum_n_bands);
-  }
-
-  if (!self->data->spectrum_freqs.empty()) {
-    const auto min_freq = static_cast<float>(g_settings_get_int(self->settings_spectrum, "minimum-frequency"));
-    const auto max_freq = static_cast<float>(g_settings_get_int(self->settings_spectrum, "maximum-frequency"));
-
-    if (min_freq > (max_freq - 100.0F)) {
-      return;
-    }
-
-    self->data->spectrum_x_axis =
-        util::logspace(min_freq, max_freq, g_settings_get_int(self->settings_spectrum, "n-points"));
-
-    const auto x_axis_size = self->data->spectrum_x_axis.size();
-
-    self->data->spectrum_mag.resize(x_axis_size);
-
-    self->data->spectrum_bin_count.resize(x_axis_size);
-
-    ui::chart::set_x_data(self->spectrum_chart, self->data->spectrum_x_axis);
-  }
-}
-
 void setup_spectrum(EffectsBox* self) {
-  self->data->spectrum_rate = 0U;
-  self->data->spectrum_n_bands = 0U;
+  self->data->spectrum_axis_serial = 0U;
 
   ui::chart::set_color(self->spectrum_chart, util::gsettings_get_color(self->settings_spectrum, "color"));
 
@@ -216,27 +184,8 @@ void setup_spectrum(EffectsBox* self) {
         }
       }),
       self));
-
-  self->data->gconnections_spectrum.push_back(g_signal_connect(
-      self->settings_spectrum, "changed::n-points", G_CALLBACK(+[](GSettings* settings, char* key, EffectsBox* self) {
-        util::idle_add([=]() { init_spectrum_frequency_axis(self); });
-      }),
-      self));
-
-  self->data->gconnections_spectrum.push_back(
-      g_signal_connect(self->settings_spectrum, "changed::minimum-frequency",
-                       G_CALLBACK(+[](GSettings* settings, char* key, EffectsBox* self) {
-                         util::idle_add([=]() { init_spectrum_frequency_axis(self); });
-                       }),
-                       self));
-
-  self->data->gconnections_spectrum.push_back(
-      g_signal_connect(self->settings_spectrum, "changed::maximum-frequency",
-                       G_CALLBACK(+[](GSettings* settings, char* key, EffectsBox* self) {
-                         util::idle_add([=]() { init_spectrum_frequency_axis(self); });
-                       }),
-                       self));
 }
+
 void stack_visible_child_changed(EffectsBox* self, GParamSpec* pspec, GtkWidget* stack) {
   const auto* name = adw_view_stack_get_visible_child_name(ADW_VIEW_STACK(stack));
 
@@ -317,98 +266,38 @@ void setup(EffectsBox* self, app::Application* application, PipelineType pipelin
   ui::plugins_box::setup(self->pluginsBox, application, pipeline_type);
   ui::blocklist_menu::setup(self->blocklist_menu, application, pipeline_type);
 
-  // output level
-
-  self->data->connections.push_back(
-      self->data->effects_base->output_level->output_level.connect([=](const float& left, const float& right) {
-        self->data->global_output_level_left = left;
-        self->data->global_output_level_right = right;
-
-        if (!self->data->schedule_signal_idle) {
-          return;
-        }
+  // output level and spectrum are read on the frame clock while they are on screen
 
-        g_idle_add((GSourceFunc) +
-                       [](EffectsBox* self) {
-                         gtk_label_set_text(self->label_global_output_level_left,
-                                            fmt::format("{0:.0f}", self->data->global_output_level_left).c_str());
-
-                         gtk_label_set_text(self->label_global_output_level_right,
-                                            fmt::format("{0:.0f}", self->data->global_output_level_right).c_str());
-
-                         gtk_widget_set_opacity(
-                             GTK_WIDGET(self->saturation_icon),
-                             (self->data->global_output_level_left > 0.0 || self->data->global_output_level_right > 0.0)
-                                 ? 1.0
-                                 : 0.0);
-
-                         return G_SOURCE_REMOVE;
-                       },
-                   self);
-      }));
-
-  // spectrum array
-
-  self->data->connections.push_back(
-      self->data->effects_base->spectrum->power.connect([=](uint rate, uint n_bands, std::vector<float> magnitudes) {
-        if (!ui::chart::get_is_visible(self->spectrum_chart)) {
-          return;
-        }
-
-        if (!self->data->schedule_signal_idle) {
-          return;
-        }
-
-        if (self->data->spectrum_rate != rate || self->data->spectrum_n_bands != n_bands) {
-          self->data->spectrum_rate = rate;
-          self->data->spectrum_n_bands = n_bands;
-
-          init_spectrum_frequency_axis(self);
-        }
-
-        std::ranges::fill(self->data->spectrum_mag, 0.0F);
-        std::ranges::fill(self->data->spectrum_bin_count, 0U);
-
-        // reducing the amount of data so we can plot them
+  add_tick_callback(GTK_WIDGET(self), [=, serial = 0U, levels = PluginBase::Levels()]() mutable {
+    if (!self->data->effects_base->output_level->get_levels(levels, serial)) {
+      return;
+    }
 
-        size_t last_j = 0;
+    gtk_label_set_text(self->label_global_output_level_left, fmt::format("{0:.0f}", levels.output_left).c_str());
 
-        for (size_t n = 0U; n < self->data->spectrum_x_axis.size(); n++) {
-          for (size_t j = last_j; j < self->data->spectrum_freqs.size(); j++) {
-            if (self->data->spectrum_freqs[j] > self->data->spectrum_x_axis[n]) {
-              last_j = j;
+    gtk_label_set_text(self->label_global_output_level_right, fmt::format("{0:.0f}", levels.output_right).c_str());
 
-              break;
-            } else {
-              self->data->spectrum_mag[n] += magnitudes[j];
+    gtk_widget_set_opacity(GTK_WIDGET(self->saturation_icon),
+                           (levels.output_left > 0.0 || levels.output_right > 0.0) ? 1.0 : 0.0);
+  });
 
-              self->data->spectrum_bin_count[n]++;
-            }
-          }
-        }
+  add_tick_callback(GTK_WIDGET(self->spectrum_chart), [=]() {
+    // The analyzer already did the binning and the dB conversion. We only take its newest frame.
 
-        for (size_t n = 0U; n < self->data->spectrum_bin_count.size(); n++) {
-          if (self->data->spectrum_bin_count[n] != 0U) {
-            continue;
-          }
+    auto& frame = self->data->spectrum_frame;
 
-          if (n > 0U && n < self->data->spectrum_bin_count.size() + 1) {
-            self->data->spectrum_mag[n] = self->data->spectrum_mag[n - 1U];
-          }
-        }
+    if (!self->data->effects_base->spectrum->get_frame(frame)) {
+      return;
+    }
 
-        std::ranges::for_each(self->data->spectrum_mag, [](auto& v) {
-          v = 10.0F * std::log10(v);
+    if (frame.axis_serial != self->data->spectrum_axis_serial) {
+      self->data->spectrum_axis_serial = frame.axis_serial;
 
-          if (!std::isinf(v)) {
-            v = (v > util::minimum_db_level) ? v : util::minimum_db_level;
-          } else {
-            v = util::minimum_db_level;
-          }
-        });
+      ui::chart::set_x_data(self->spectrum_chart, frame.frequencies);
+    }
 
-        ui::chart::set_y_data(self->spectrum_chart, self->data->spectrum_mag);
-      }));
+    ui::chart::set_y_data(self->spectrum_chart, frame.magnitudes);
+  });
 
   // As we are showing the window we want the filters to send notifications about level meters, etc
 
@@ -131,6 +131,23 @@ void setup(EqualizerBandBox* self, GSettings* settings, int index) {
   g_settings_bind(settings, tags::equalizer::band_slope[index], self->band_slope, "active-id", G_SETTINGS_BIND_DEFAULT);
 }
 
+void unbind(EqualizerBandBox* self) {
+  if (self->settings == nullptr) {
+    return;
+  }
+
+  g_settings_unbind(gtk_range_get_adjustment(GTK_RANGE(self->band_scale)), "value");
+  g_settings_unbind(gtk_spin_button_get_adjustment(self->band_frequency), "value");
+  g_settings_unbind(gtk_spin_button_get_adjustment(self->band_quality), "value");
+  g_settings_unbind(self->band_solo, "active");
+  g_settings_unbind(self->band_mute, "active");
+  g_settings_unbind(self->band_type, "active-id");
+  g_settings_unbind(self->band_mode, "active-id");
+  g_settings_unbind(self->band_slope, "active-id");
+
+  self->settings = nullptr;
+}
+
 void dispose(GObject* object) {
   auto* self = EE_EQUALIZER_BAND_BOX(object);
 
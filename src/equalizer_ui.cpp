@@ -28,8 +28,6 @@ auto constexpr log_tag = "equalizer_box: ";
 
 constexpr int max_bands = 32U;
 
-enum Channel { left, right };
-
 struct APO_Band {
   std::string type;
   float freq = 1000.0f;
@@ -53,7 +51,9 @@ struct Data {
 
   std::vector<sigc::connection> connections;
 
-  std::vector<gulong> gconnections, gconnections_left, gconnections_right;
+  std::vector<gulong> gconnections;
+
+  GtkStringList* bands_model = nullptr;  // one item per band holding its index
 };
 
 struct _EqualizerBox {
@@ -69,7 +69,7 @@ struct _EqualizerBox {
 
   GtkStack* stack;
 
-  GtkBox *bands_box_left, *bands_box_right;
+  GtkListView *bands_listview_left, *bands_listview_right;
 
   GtkSpinButton* nbands;
 
@@ -382,66 +382,79 @@ void on_import_apo_preset_clicked(EqualizerBox* self, GtkButton* btn) {
   gtk_native_dialog_show(GTK_NATIVE_DIALOG(dialog));
 }
 
-template <Channel channel>
-void build_channel_bands(EqualizerBox* self, const int& nbands, const bool& split_mode) {
-  GSettings* settings;
-  GtkBox* bands_box;
+/*
+  The band editors live in list views. Only the bands that are on screen have a widget and a widget is bound to the
+  settings of a band only while it shows that band. Scrolling through the bands recycles the same few widgets.
+*/
 
-  if constexpr (channel == Channel::left) {
-    settings = self->settings_left;
+void setup_bands_listview(EqualizerBox* self, GtkListView* listview, GSettings* settings) {
+  auto* factory = gtk_signal_list_item_factory_new();
 
-    bands_box = self->bands_box_left;
-  } else if constexpr (channel == Channel::right) {
-    settings = self->settings_right;
+  g_signal_connect(factory, "setup",
+                   G_CALLBACK(+[](GtkSignalListItemFactory* factory, GtkListItem* item, GSettings* settings) {
+                     gtk_list_item_set_child(item, GTK_WIDGET(ui::equalizer_band_box::create()));
 
-    bands_box = self->bands_box_right;
-  }
+                     // the band widgets take the keyboard focus themselves
 
-  for (int n = 0; n < nbands; n++) {
-    auto band_box = ui::equalizer_band_box::create();
+                     gtk_list_item_set_activatable(item, 0);
+                   }),
+                   settings);
 
-    ui::equalizer_band_box::setup(band_box, settings, n);
+  g_signal_connect(factory, "bind",
+                   G_CALLBACK(+[](GtkSignalListItemFactory* factory, GtkListItem* item, GSettings* settings) {
+                     auto* band_box = EE_EQUALIZER_BAND_BOX(gtk_list_item_get_child(item));
 
-    gtk_box_append(bands_box, GTK_WIDGET(band_box));
-  }
-}
+                     const auto index =
+                         std::stoi(gtk_string_object_get_string(GTK_STRING_OBJECT(gtk_list_item_get_item(item))));
 
-void build_all_bands(EqualizerBox* self) {
-  for (auto& handler_id : self->data->gconnections_left) {
-    g_signal_handler_disconnect(self->settings_left, handler_id);
-  }
+                     ui::equalizer_band_box::setup(band_box, settings, index);
+                   }),
+                   settings);
 
-  for (auto& handler_id : self->data->gconnections_right) {
-    g_signal_handler_disconnect(self->settings_right, handler_id);
-  }
+  g_signal_connect(factory, "unbind",
+                   G_CALLBACK(+[](GtkSignalListItemFactory* factory, GtkListItem* item, GSettings* settings) {
+                     ui::equalizer_band_box::unbind(EE_EQUALIZER_BAND_BOX(gtk_list_item_get_child(item)));
+                   }),
+                   settings);
 
-  self->data->gconnections_left.clear();
-  self->data->gconnections_right.clear();
+  gtk_list_view_set_factory(listview, factory);
 
-  for (auto* child = gtk_widget_get_first_child(GTK_WIDGET(self->bands_box_left)); child != nullptr;) {
-    auto* next_child = gtk_widget_get_next_sibling(child);
+  g_object_unref(factory);
 
-    gtk_box_remove(self->bands_box_left, child);
+  // the selection model takes ownership of the reference we give it
 
-    child = next_child;
-  }
+  auto* selection = gtk_no_selection_new(G_LIST_MODEL(g_object_ref(self->data->bands_model)));
 
-  for (auto* child = gtk_widget_get_first_child(GTK_WIDGET(self->bands_box_right)); child != nullptr;) {
-    auto* next_child = gtk_widget_get_next_sibling(child);
+  gtk_list_view_set_model(listview, GTK_SELECTION_MODEL(selection));
 
-    gtk_box_remove(self->bands_box_right, child);
+  g_object_unref(selection);
+}
 
-    child = next_child;
-  }
+// Changing the number of bands only adds or removes items at the end of the model
 
-  const auto split = g_settings_get_boolean(self->settings, "split-channels") != 0;
+void update_bands_model(EqualizerBox* self) {
+  const auto nbands = static_cast<guint>(g_settings_get_int(self->settings, "num-bands"));
 
-  const auto nbands = g_settings_get_int(self->settings, "num-bands");
+  const auto n_items = g_list_model_get_n_items(G_LIST_MODEL(self->data->bands_model));
+
+  if (nbands < n_items) {
+    gtk_string_list_splice(self->data->bands_model, nbands, n_items - nbands, nullptr);
+  } else if (nbands > n_items) {
+    std::vector<std::string> indices;
+
+    for (auto n = n_items; n < nbands; n++) {
+      indices.push_back(util::to_string(n));
+    }
+
+    auto additions = std::vector<const char*>();
+
+    for (const auto& index : indices) {
+      additions.push_back(index.c_str());
+    }
 
-  build_channel_bands<Channel::left>(self, nbands, split);
+    additions.push_back(nullptr);
 
-  if (split) {
-    build_channel_bands<Channel::right>(self, nbands, split);
+    gtk_string_list_splice(self->data->bands_model, n_items, 0, additions.data());
   }
 }
 
@@ -464,17 +477,16 @@ void setup(EqualizerBox* self,
   equalizer->post_messages = true;
   equalizer->bypass = false;
 
-  build_all_bands(self);
+  self->data->bands_model = gtk_string_list_new(nullptr);
 
-  self->data->connections.push_back(equalizer->input_level.connect([=](const float& left, const float& right) {
-    update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                 self->input_level_right_label, left, right);
-  }));
+  setup_bands_listview(self, self->bands_listview_left, self->settings_left);
+  setup_bands_listview(self, self->bands_listview_right, self->settings_right);
 
-  self->data->connections.push_back(equalizer->output_level.connect([=](const float& left, const float& right) {
-    update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                 self->output_level_right_label, left, right);
-  }));
+  update_bands_model(self);
+
+  add_level_meters_tick(GTK_WIDGET(self), equalizer, self->input_level_left, self->input_level_left_label,
+                        self->input_level_right, self->input_level_right_label, self->output_level_left,
+                        self->output_level_left_label, self->output_level_right, self->output_level_right_label);
 
   gsettings_bind_widgets<"input-gain", "output-gain">(self->settings, self->input_gain, self->output_gain);
 
@@ -487,13 +499,11 @@ void setup(EqualizerBox* self,
 
   self->data->gconnections.push_back(g_signal_connect(
       self->settings, "changed::num-bands",
-      G_CALLBACK(+[](GSettings* settings, char* key, EqualizerBox* self) { build_all_bands(self); }), self));
+      G_CALLBACK(+[](GSettings* settings, char* key, EqualizerBox* self) { update_bands_model(self); }), self));
 
   self->data->gconnections.push_back(g_signal_connect(
       self->settings, "changed::split-channels", G_CALLBACK(+[](GSettings* settings, char* key, EqualizerBox* self) {
         gtk_stack_set_visible_child_name(self->stack, "page_left_channel");
-
-        build_all_bands(self);
       }),
       self));
 }
@@ -511,18 +521,10 @@ void dispose(GObject* object) {
     g_signal_handler_disconnect(self->settings, handler_id);
   }
 
-  for (auto& handler_id : self->data->gconnections_left) {
-    g_signal_handler_disconnect(self->settings_left, handler_id);
-  }
-
-  for (auto& handler_id : self->data->gconnections_right) {
-    g_signal_handler_disconnect(self->settings_right, handler_id);
-  }
-
   self->data->connections.clear();
   self->data->gconnections.clear();
-  self->data->gconnections_left.clear();
-  self->data->gconnections_right.clear();
+
+  g_object_unref(self->data->bands_model);
 
   g_object_unref(self->settings);
   g_object_unref(self->settings_left);
@@ -566,8 +568,8 @@ void equalizer_box_class_init(EqualizerBoxClass* klass) {
   gtk_widget_class_bind_template_child(widget_class, EqualizerBox, bypass);
 
   gtk_widget_class_bind_template_child(widget_class, EqualizerBox, stack);
-  gtk_widget_class_bind_template_child(widget_class, EqualizerBox, bands_box_left);
-  gtk_widget_class_bind_template_child(widget_class, EqualizerBox, bands_box_right);
+  gtk_widget_class_bind_template_child(widget_class, EqualizerBox, bands_listview_left);
+  gtk_widget_class_bind_template_child(widget_class, EqualizerBox, bands_listview_right);
   gtk_widget_class_bind_template_child(widget_class, EqualizerBox, nbands);
   gtk_widget_class_bind_template_child(widget_class, EqualizerBox, mode);
   gtk_widget_class_bind_template_child(widget_class, EqualizerBox, split_channels);
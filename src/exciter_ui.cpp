@@ -82,15 +82,9 @@ void setup(ExciterBox* self, std::shared_ptr<Exciter> exciter, const std::string
   exciter->post_messages = true;
   exciter->bypass = false;
 
-  self->data->connections.push_back(exciter->input_level.connect([=](const float& left, const float& right) {
-    update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                 self->input_level_right_label, left, right);
-  }));
-
-  self->data->connections.push_back(exciter->output_level.connect([=](const float& left, const float& right) {
-    update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                 self->output_level_right_label, left, right);
-  }));
+  add_level_meters_tick(GTK_WIDGET(self), exciter, self->input_level_left, self->input_level_left_label,
+                        self->input_level_right, self->input_level_right_label, self->output_level_left,
+                        self->output_level_left_label, self->output_level_right, self->output_level_right_label);
 
   self->data->connections.push_back(exciter->harmonics.connect([=](const double& value) {
     gtk_level_bar_set_value(self->harmonics_levelbar, value);
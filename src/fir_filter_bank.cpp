@@ -0,0 +1,230 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "fir_filter_bank.hpp"
+
+FirFilterBank::FirFilterBank(std::string tag, const uint& n_bands)
+    : log_tag(std::move(tag)),
+      n_bands(n_bands),
+      min_frequencies(n_bands, 20.0F),
+      max_frequencies(n_bands, 22000.0F),
+      band_spectra(n_bands, nullptr) {}
+
+FirFilterBank::~FirFilterBank() {
+  ready = false;
+
+  free_buffers();
+}
+
+void FirFilterBank::set_rate(const uint& value) {
+  rate = value;
+}
+
+void FirFilterBank::set_n_samples(const uint& value) {
+  n_samples = value;
+}
+
+void FirFilterBank::set_transition_band(const float& value) {
+  transition_band = value;
+}
+
+void FirFilterBank::set_band_frequencies(const uint& band, const float& min_frequency, const float& max_frequency) {
+  min_frequencies.at(band) = min_frequency;
+  max_frequencies.at(band) = max_frequency;
+}
+
+auto FirFilterBank::is_ready() const -> bool {
+  return ready;
+}
+
+auto FirFilterBank::get_delay() const -> float {
+  return delay;
+}
+
+void FirFilterBank::free_buffers() {
+  if (forward_plan != nullptr) {
+    fftwf_destroy_plan(forward_plan);
+  }
+
+  if (backward_plan != nullptr) {
+    fftwf_destroy_plan(backward_plan);
+  }
+
+  forward_plan = nullptr;
+  backward_plan = nullptr;
+
+  for (auto& spectrum : band_spectra) {
+    if (spectrum != nullptr) {
+      fftwf_free(spectrum);
+    }
+
+    spectrum = nullptr;
+  }
+
+  for (auto* channel : {&channel_L, &channel_R}) {
+    if (channel->window != nullptr) {
+      fftwf_free(channel->window);
+    }
+
+    if (channel->delay_line != nullptr) {
+      fftwf_free(channel->delay_line);
+    }
+
+    channel->window = nullptr;
+    channel->delay_line = nullptr;
+    channel->newest = 0U;
+  }
+
+  if (accumulator != nullptr) {
+    fftwf_free(accumulator);
+  }
+
+  if (time_output != nullptr) {
+    fftwf_free(time_output);
+  }
+
+  accumulator = nullptr;
+  time_output = nullptr;
+}
+
+void FirFilterBank::setup() {
+  ready = false;
+
+  free_buffers();
+
+  if (n_samples == 0U || rate == 0U) {
+    return;
+  }
+
+  std::vector<FirKernelCache::Kernel> kernels(n_bands);
+
+  for (uint n = 0U; n < n_bands; n++) {
+    kernels[n] = FirKernelCache::get().get_bandpass(rate, min_frequencies[n], max_frequencies[n], transition_band);
+
+    if (kernels[n]->empty()) {
+      util::warning(log_tag + "could not create the kernel of band " + util::to_string(n));
+
+      return;
+    }
+  }
+
+  const auto kernel_size = std::ranges::max(kernels, {}, [](const auto& k) { return k->size(); })->size();
+
+  delay = 0.5F * static_cast<float>(kernel_size - 1U) / static_cast<float>(rate);
+
+  /*
+    Each partition of n_samples taps is zero padded to 2 * n_samples so that the last n_samples values of the circular
+    convolution are the linear convolution we want (overlap-save). The bins stride is rounded so that every spectrum in
+    the delay line keeps the alignment fftw had when the plans were made.
+  */
+
+  fft_size = 2U * n_samples;
+  n_bins = n_samples + 1U;
+  bins_stride = (n_bins + 3U) & ~3U;
+  n_partitions = (kernel_size + n_samples - 1U) / n_samples;
+
+  for (auto* channel : {&channel_L, &channel_R}) {
+    channel->window = fftwf_alloc_real(fft_size);
+    channel->delay_line = fftwf_alloc_complex(static_cast<size_t>(n_partitions) * bins_stride);
+
+    std::fill_n(channel->window, fft_size, 0.0F);
+    std::fill_n(&channel->delay_line[0][0], 2U * n_partitions * bins_stride, 0.0F);
+  }
+
+  accumulator = fftwf_alloc_complex(bins_stride);
+  time_output = fftwf_alloc_real(fft_size);
+
+  forward_plan = fftwf_plan_dft_r2c_1d(static_cast<int>(fft_size), channel_L.window, channel_L.delay_line,
+                                       FFTW_ESTIMATE);
+
+  backward_plan = fftwf_plan_dft_c2r_1d(static_cast<int>(fft_size), accumulator, time_output, FFTW_ESTIMATE);
+
+  // fftw does not normalize the inverse transform. We do it once here instead of doing it for every block.
+
+  const float scale = 1.0F / static_cast<float>(fft_size);
+
+  for (uint n = 0U; n < n_bands; n++) {
+    band_spectra[n] = fftwf_alloc_complex(static_cast<size_t>(n_partitions) * bins_stride);
+
+    std::fill_n(&band_spectra[n][0][0], 2U * n_partitions * bins_stride, 0.0F);
+
+    for (uint p = 0U; p < n_partitions; p++) {
+      const auto first = static_cast<size_t>(p) * n_samples;
+      const auto& kernel = *kernels[n];
+
+      const auto count = std::min(static_cast<size_t>(n_samples), kernel.size() - std::min(first, kernel.size()));
+
+      std::fill_n(time_output, fft_size, 0.0F);
+
+      for (size_t m = 0U; m < count; m++) {
+        time_output[m] = kernel[first + m] * scale;
+      }
+
+      fftwf_execute_dft_r2c(forward_plan, time_output, band_spectra[n] + static_cast<size_t>(p) * bins_stride);
+    }
+  }
+
+  ready = true;
+
+  util::debug(log_tag + "filter bank is ready. Partitions: " + util::to_string(n_partitions));
+}
+
+void FirFilterBank::push(std::span<const float> data_left, std::span<const float> data_right) {
+  push_channel(channel_L, data_left);
+  push_channel(channel_R, data_right);
+}
+
+void FirFilterBank::get_output(std::span<const uint> bands, float* output_left, float* output_right) {
+  get_channel_output(channel_L, bands, output_left);
+  get_channel_output(channel_R, bands, output_right);
+}
+
+void FirFilterBank::push_channel(Channel& channel, std::span<const float> data) {
+  // sliding the input window and transforming it only once for all bands
+
+  std::copy_n(channel.window + n_samples, n_samples, channel.window);
+  std::copy_n(data.begin(), n_samples, channel.window + n_samples);
+
+  channel.newest = (channel.newest + n_partitions - 1U) % n_partitions;
+
+  fftwf_execute_dft_r2c(forward_plan, channel.window,
+                        channel.delay_line + static_cast<size_t>(channel.newest) * bins_stride);
+}
+
+void FirFilterBank::get_channel_output(const Channel& channel, std::span<const uint> bands, float* output) {
+  std::fill_n(&accumulator[0][0], 2U * n_bins, 0.0F);
+
+  for (const auto& n : bands) {
+    for (uint p = 0U; p < n_partitions; p++) {
+      const auto slot = (channel.newest + p) % n_partitions;
+
+      const fftwf_complex* x = channel.delay_line + static_cast<size_t>(slot) * bins_stride;
+      const fftwf_complex* h = band_spectra[n] + static_cast<size_t>(p) * bins_stride;
+
+      for (uint k = 0U; k < n_bins; k++) {
+        accumulator[k][0] += x[k][0] * h[k][0] - x[k][1] * h[k][1];
+        accumulator[k][1] += x[k][0] * h[k][1] + x[k][1] * h[k][0];
+      }
+    }
+  }
+
+  fftwf_execute_dft_c2r(backward_plan, accumulator, time_output);
+
+  std::copy_n(time_output + n_samples, n_samples, output);
+}
@@ -19,26 +19,11 @@
 
 #include "fir_filter_base.hpp"
 
-namespace {
-
-constexpr auto CONVPROC_SCHEDULER_PRIORITY = 0;
-
-constexpr auto CONVPROC_SCHEDULER_CLASS = SCHED_FIFO;
-
-}  // namespace
-
-FirFilterBase::FirFilterBase(std::string tag) : log_tag(std::move(tag)) {}
+FirFilterBase::FirFilterBase(std::string tag)
+    : log_tag(std::move(tag)), conv(std::make_unique<PartitionedConvolver>(log_tag)) {}
 
 FirFilterBase::~FirFilterBase() {
-  zita_ready = false;
-
-  if (conv != nullptr) {
-    conv->stop_process();
-
-    conv->cleanup();
-
-    delete conv;
-  }
+  convolver_ready = false;
 }
 
 void FirFilterBase::set_rate(const uint& value) {
@@ -63,132 +48,20 @@ void FirFilterBase::set_transition_band(const float& value) {
 
 void FirFilterBase::setup() {}
 
-auto FirFilterBase::create_lowpass_kernel(const float& cutoff, const float& transition_band) const
-    -> std::vector<float> {
-  std::vector<float> output;
-
-  if (rate == 0) {
-    return output;
-  }
-
-  /*
-    transition band frequency as a fraction of the sample rate
-  */
-
-  const float b = transition_band / static_cast<float>(rate);
-
-  /*
-      The kernel size must be odd: M + 1 where M is even. This is done so it can be symmetric around the main lobe
-      https://www.dspguide.com/ch16/1.htm
-
-      The kernel size is related to the transition bandwidth M = 4/BW
-  */
-
-  size_t M = std::ceil(4.0F / b);
-
-  M = (M % 2 == 0) ? M : M + 1;  // checking if M is even
-
-  output.resize(M + 1);
-
-  /*
-    cutoff frequency as a fraction of the sample rate
-  */
-
-  const float fc = cutoff / static_cast<float>(rate);
-
-  float sum = 0.0F;
-
-  for (size_t n = 0U; n < output.size(); n++) {
-    /*
-      windowed-sinc kernel https://www.dspguide.com/ch16/1.htm
-    */
-
-    if (n == M / 2U) {
-      output[n] = 2.0F * std::numbers::pi_v<float> * fc;
-    } else {
-      output[n] = std::sin(2.0F * std::numbers::pi_v<float> * fc * static_cast<float>(n - static_cast<uint>(M / 2U))) /
-                  static_cast<float>(n - static_cast<uint>(M / 2U));
-    }
-
-    /*
-      Blackman window https://www.dspguide.com/ch16/1.htm
-    */
-
-    const float w = 0.42F -
-                    0.5F * std::cos(2.0F * std::numbers::pi_v<float> * static_cast<float>(n) / static_cast<float>(M)) +
-                    0.08F * std::cos(4.0F * std::numbers::pi_v<float> * static_cast<float>(n) / static_cast<float>(M));
-
-    output[n] *= w;
-
-    sum += output[n];
-  }
-
-  /*
-    Normalizing so that we have unit gain at zero frequency
-  */
-
-  std::ranges::for_each(output, [&](auto& v) { v /= sum; });
-
-  return output;
-}
-
-void FirFilterBase::setup_zita() {
-  zita_ready = false;
-
-  if (n_samples == 0U || kernel.empty()) {
-    return;
-  }
-
-  if (conv != nullptr) {
-    conv->stop_process();
-
-    conv->cleanup();
-
-    delete conv;
-  }
-
-  conv = new Convproc();
-
-  conv->set_options(0);
-
-  int ret = conv->configure(2, 2, kernel.size(), n_samples, n_samples, n_samples, 0.0F /*density*/);
-
-  if (ret != 0) {
-    util::warning(log_tag + "can't initialise zita-convolver engine: " + util::to_string(ret, ""));
-
-    return;
-  }
-
-  ret = conv->impdata_create(0, 0, 1, kernel.data(), 0, static_cast<int>(kernel.size()));
-
-  if (ret != 0) {
-    util::warning(log_tag + "left impdata_create failed: " + util::to_string(ret, ""));
-
-    return;
-  }
-
-  ret = conv->impdata_create(1, 1, 1, kernel.data(), 0, static_cast<int>(kernel.size()));
-
-  if (ret != 0) {
-    util::warning(log_tag + "right impdata_create failed: " + util::to_string(ret, ""));
+void FirFilterBase::setup_convolver() {
+  convolver_ready = false;
 
+  if (n_samples == 0U || kernel == nullptr || kernel->empty()) {
     return;
   }
 
-  ret = conv->start_process(CONVPROC_SCHEDULER_PRIORITY, CONVPROC_SCHEDULER_CLASS);
-
-  if (ret != 0) {
-    util::warning(log_tag + "start_process failed: " + util::to_string(ret, ""));
-
-    conv->stop_process();
-    conv->cleanup();
+  if (!conv->configure(n_samples, *kernel, *kernel)) {
+    util::warning(log_tag + "can't initialise the convolution engine");
 
     return;
   }
 
-  // conv->print();
-
-  zita_ready = true;
+  convolver_ready = true;
 }
 
 void FirFilterBase::direct_conv(const std::vector<float>& a, const std::vector<float>& b, std::vector<float>& c) {
@@ -24,13 +24,9 @@ FirFilterHighpass::FirFilterHighpass(std::string tag) : FirFilterBase(std::move(
 FirFilterHighpass::~FirFilterHighpass() = default;
 
 void FirFilterHighpass::setup() {
-  kernel = create_lowpass_kernel(min_frequency, transition_band);
+  kernel = FirKernelCache::get().get_highpass(rate, min_frequency, transition_band);
 
-  std::ranges::for_each(kernel, [](auto& v) { v *= -1.0F; });
+  delay = 0.5F * static_cast<float>(kernel->size() - 1U) / static_cast<float>(rate);
 
-  kernel[(kernel.size() - 1U) / 2U] += 1.0F;
-
-  delay = 0.5F * static_cast<float>(kernel.size() - 1U) / static_cast<float>(rate);
-
-  setup_zita();
+  setup_convolver();
 }
@@ -24,9 +24,9 @@ FirFilterLowpass::FirFilterLowpass(std::string tag) : FirFilterBase(std::move(ta
 FirFilterLowpass::~FirFilterLowpass() = default;
 
 void FirFilterLowpass::setup() {
-  kernel = create_lowpass_kernel(max_frequency, transition_band);
+  kernel = FirKernelCache::get().get_lowpass(rate, max_frequency, transition_band);
 
-  delay = 0.5F * static_cast<float>(kernel.size() - 1U) / static_cast<float>(rate);
+  delay = 0.5F * static_cast<float>(kernel->size() - 1U) / static_cast<float>(rate);
 
-  setup_zita();
+  setup_convolver();
 }
@@ -0,0 +1,216 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "fir_kernel_cache.hpp"
+
+auto FirKernelCache::get() -> FirKernelCache& {
+  static FirKernelCache cache;
+
+  return cache;
+}
+
+auto FirKernelCache::get_lowpass(const uint& rate, const float& cutoff, const float& transition_band) -> Kernel {
+  return find_or_design({Type::lowpass, rate, 0.0F, cutoff, transition_band});
+}
+
+auto FirKernelCache::get_highpass(const uint& rate, const float& cutoff, const float& transition_band) -> Kernel {
+  return find_or_design({Type::highpass, rate, cutoff, 0.0F, transition_band});
+}
+
+auto FirKernelCache::get_bandpass(const uint& rate,
+                                  const float& min_frequency,
+                                  const float& max_frequency,
+                                  const float& transition_band) -> Kernel {
+  return find_or_design({Type::bandpass, rate, min_frequency, max_frequency, transition_band});
+}
+
+auto FirKernelCache::find_or_design(const Key& key) -> Kernel {
+  {
+    std::scoped_lock<std::mutex> lock(kernels_mutex);
+
+    if (auto it = kernels.find(key); it != kernels.end()) {
+      if (auto kernel = it->second.lock()) {
+        hits++;
+
+        return kernel;
+      }
+    }
+  }
+
+  // the design is done without holding the lock because the bandpass asks for its lowpass kernels
+
+  auto kernel = std::make_shared<const std::vector<float>>(design(key));
+
+  std::scoped_lock<std::mutex> lock(kernels_mutex);
+
+  misses++;
+
+  // forgetting the kernels nobody uses anymore
+
+  std::erase_if(kernels, [](const auto& item) { return item.second.expired(); });
+
+  kernels[key] = kernel;
+
+  util::debug(log_tag + "designed a kernel with " + util::to_string(kernel->size()) + " taps. Hits: " +
+              util::to_string(hits) + ", misses: " + util::to_string(misses));
+
+  return kernel;
+}
+
+auto FirKernelCache::design(const Key& key) -> std::vector<float> {
+  switch (key.type) {
+    case Type::lowpass:
+      return design_lowpass(key.rate, key.max_frequency, key.transition_band);
+
+    case Type::highpass: {
+      auto output = design_lowpass(key.rate, key.min_frequency, key.transition_band);
+
+      if (!output.empty()) {
+        spectral_inversion(output);
+      }
+
+      return output;
+    }
+
+    case Type::bandpass: {
+      const auto lowpass_kernel = get_lowpass(key.rate, key.max_frequency, key.transition_band);
+
+      // high-pass kernel
+
+      const auto highpass_kernel = get_highpass(key.rate, key.min_frequency, key.transition_band);
+
+      std::vector<float> output;
+
+      if (lowpass_kernel->empty() || highpass_kernel->empty()) {
+        return output;
+      }
+
+      output.resize(highpass_kernel->size());
+
+      /*
+        Creating a bandpass from a band reject through spectral inversion https://www.dspguide.com/ch16/4.htm
+      */
+
+      for (size_t n = 0U; n < output.size(); n++) {
+        output[n] = (*lowpass_kernel)[n] + (*highpass_kernel)[n];
+      }
+
+      spectral_inversion(output);
+
+      return output;
+    }
+  }
+
+  return {};
+}
+
+auto FirKernelCache::design_lowpass(const uint& rate, const float& cutoff, const float& transition_band)
+    -> std::vector<float> {
+  std::vector<float> output;
+
+  if (rate == 0U) {
+    return output;
+  }
+
+  /*
+    transition band frequency as a fraction of the sample rate
+  */
+
+  const float b = transition_band / static_cast<float>(rate);
+
+  /*
+      The kernel size must be odd: M + 1 where M is even. This is done so it can be symmetric around the main lobe
+      https://www.dspguide.com/ch16/1.htm
+
+      The kernel size is related to the transition bandwidth M = 4/BW
+  */
+
+  size_t M = std::ceil(4.0F / b);
+
+  M = (M % 2 == 0) ? M : M + 1;  // checking if M is even
+
+  output.resize(M + 1);
+
+  const size_t half = M / 2U;
+
+  /*
+    cutoff frequency as a fraction of the sample rate
+  */
+
+  const double fc = static_cast<double>(cutoff) / static_cast<double>(rate);
+
+  /*
+    windowed-sinc kernel with a Blackman window https://www.dspguide.com/ch16/1.htm
+
+    Both are symmetric around the center tap, so only the right half is evaluated and then mirrored. Relative to the
+    center the window is 0.42 + 0.5 * cos(theta * k) + 0.08 * cos(2 * theta * k) with theta = 2 * pi / M. The sine of
+    the sinc and the cosine of the window are advanced by complex rotations instead of being evaluated for every tap.
+    Double precision keeps the error the rotations accumulate far below the resolution of the float kernel.
+  */
+
+  const double sinc_step = 2.0 * std::numbers::pi * fc;
+  const double window_step = 2.0 * std::numbers::pi / static_cast<double>(M);
+
+  const double sinc_step_cos = std::cos(sinc_step);
+  const double sinc_step_sin = std::sin(sinc_step);
+  const double window_step_cos = std::cos(window_step);
+  const double window_step_sin = std::sin(window_step);
+
+  double sinc_cos = 1.0;
+  double sinc_sin = 0.0;
+  double window_cos = 1.0;
+  double window_sin = 0.0;
+
+  std::span right_half{output.begin() + half, output.end()};
+
+  double sum = 0.0;
+
+  for (size_t k = 0U; k < right_half.size(); k++) {
+    const double sinc = (k == 0U) ? sinc_step : sinc_sin / static_cast<double>(k);
+
+    const double window = 0.42 + 0.5 * window_cos + 0.08 * (2.0 * window_cos * window_cos - 1.0);
+
+    right_half[k] = static_cast<float>(sinc * window);
+
+    sum += (k == 0U) ? sinc * window : 2.0 * sinc * window;
+
+    const double next_sinc_sin = sinc_sin * sinc_step_cos + sinc_cos * sinc_step_sin;
+    const double next_window_sin = window_sin * window_step_cos + window_cos * window_step_sin;
+
+    sinc_cos = sinc_cos * sinc_step_cos - sinc_sin * sinc_step_sin;
+    sinc_sin = next_sinc_sin;
+
+    window_cos = window_cos * window_step_cos - window_sin * window_step_sin;
+    window_sin = next_window_sin;
+  }
+
+  std::reverse_copy(right_half.begin() + 1, right_half.end(), output.begin());
+
+  /*
+    Normalizing so that we have unit gain at zero frequency
+  */
+
+  const auto inverse_sum = static_cast<float>(1.0 / sum);
+
+  for (auto& v : output) {
+    v *= inverse_sum;
+  }
+
+  return output;
+}
@@ -0,0 +1,289 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "fork_join.hpp"
+#include <pthread.h>
+#include <sched.h>
+
+auto ForkJoin::get() -> ForkJoin& {
+  static ForkJoin fork_join;
+
+  return fork_join;
+}
+
+ForkJoin::~ForkJoin() {
+  std::scoped_lock<std::mutex> lock(helper_mutex);
+
+  stop_helper();
+}
+
+void ForkJoin::set_enabled(const bool& value) {
+  std::scoped_lock<std::mutex> lock(helper_mutex);
+
+  if (value == helper.joinable()) {
+    return;
+  }
+
+  if (value) {
+    if (std::thread::hardware_concurrency() < 2U) {
+      util::debug(log_tag + "there is only one cpu core. The helper thread would only compete with the realtime one");
+
+      return;
+    }
+
+    start_helper();
+  } else {
+    stop_helper();
+  }
+}
+
+void ForkJoin::start_helper() {
+  stop = false;
+
+  // a new thread starts with the default scheduling policy
+
+  helper_priority = 0;
+  failed_priority = -1;
+
+  helper = std::thread([this]() { work(); });
+
+  enabled = true;
+
+  util::debug(log_tag + "helper thread started");
+}
+
+void ForkJoin::stop_helper() {
+  if (!helper.joinable()) {
+    return;
+  }
+
+  // New callers will run serially. The ones that already posted a task are served before the helper leaves.
+
+  enabled = false;
+
+  while (busy.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+
+  stop = true;
+
+  // the helper may be waiting for the state to change
+
+  state.store(quit);
+
+  state.notify_one();
+
+  helper.join();
+
+  state.store(idle);
+
+  util::debug(log_tag + "helper thread stopped. Forks: " + util::to_string(n_forks.load()) +
+              ", serial fallbacks: " + util::to_string(n_fallbacks.load()) +
+              ", late joins: " + util::to_string(n_late.load()));
+}
+
+auto ForkJoin::post(void (*function)(void*), void* data) -> bool {
+  if (!enabled.load() || busy.exchange(true)) {
+    // the helper is disabled or another realtime thread is using it
+
+    return false;
+  }
+
+  // stop_helper() may have disabled the helper before it could see that we are busy
+
+  if (!enabled.load()) {
+    busy.store(false);
+
+    return false;
+  }
+
+  // the priority of a pipewire data thread does not change after it has started
+
+  static thread_local const int caller_priority = util::get_realtime_priority();
+
+  if (caller_priority > helper_priority.load(std::memory_order_relaxed)) {
+    // the helper could be preempted while we wait for it. Ask it to raise its priority and run serially meanwhile.
+
+    if (requested_priority.load(std::memory_order_relaxed) < caller_priority) {
+      requested_priority.store(caller_priority);
+
+      state.store(retune);
+
+      if (sleeping.load()) {
+        state.notify_one();
+      }
+    }
+
+    busy.store(false);
+
+    return false;
+  }
+
+  if (n_serial_cycles.load(std::memory_order_relaxed) != 0U) {
+    // the helper was late recently
+
+    n_serial_cycles.fetch_sub(1U, std::memory_order_relaxed);
+
+    busy.store(false);
+
+    return false;
+  }
+
+  task = function;
+  task_data = data;
+
+  n_forks++;
+
+  state.store(posted);
+
+  if (sleeping.load()) {
+    state.notify_one();
+  }
+
+  return true;
+}
+
+void ForkJoin::join() {
+  auto expected = static_cast<int>(posted);
+
+  if (state.compare_exchange_strong(expected, idle, std::memory_order_acquire)) {
+    // the helper missed the deadline
+
+    n_fallbacks++;
+
+    task(task_data);
+  } else {
+    const auto deadline = std::chrono::steady_clock::now() + join_spin_duration;
+
+    while (state.load(std::memory_order_acquire) != done && std::chrono::steady_clock::now() < deadline) {
+      util::cpu_relax();
+    }
+
+    if (state.load(std::memory_order_acquire) != done) {
+      /*
+        The helper is stuck in our task and we can not take it back. Stop burning the cpu while waiting and give the
+        next cycles to the calling thread alone.
+      */
+
+      n_late++;
+
+      n_serial_cycles.store(backoff_cycles, std::memory_order_relaxed);
+
+      joining.store(true);
+
+      for (auto s = state.load(); s != done; s = state.load()) {
+        state.wait(s);
+      }
+
+      joining.store(false);
+    }
+
+    state.store(idle, std::memory_order_relaxed);
+  }
+
+  busy.store(false, std::memory_order_release);
+}
+
+void ForkJoin::apply_priority() {
+  const auto priority = requested_priority.load();
+
+  if (priority == helper_priority.load(std::memory_order_relaxed) || priority == failed_priority) {
+    return;
+  }
+
+  sched_param param{};
+
+  param.sched_priority = priority;
+
+  if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+    // the callers keep running serially
+
+    failed_priority = priority;
+
+    util::warning(log_tag + "could not set the helper thread realtime priority to " + util::to_string(priority));
+
+    return;
+  }
+
+  helper_priority.store(priority);
+
+  util::debug(log_tag + "helper thread realtime priority set to " + util::to_string(priority));
+}
+
+void ForkJoin::work() {
+  while (!stop.load(std::memory_order_relaxed)) {
+    apply_priority();
+
+    const auto deadline = std::chrono::steady_clock::now() + spin_duration;
+
+    for (auto s = state.load(std::memory_order_acquire);
+         s != posted && s != retune && !stop.load(std::memory_order_relaxed) &&
+         std::chrono::steady_clock::now() < deadline;
+         s = state.load(std::memory_order_acquire)) {
+      util::cpu_relax();
+    }
+
+    auto expected = static_cast<int>(posted);
+
+    if (state.compare_exchange_strong(expected, running, std::memory_order_acquire)) {
+      task(task_data);
+
+      // sequentially consistent, so that it pairs with the store of joining and the load of state in join()
+
+      state.store(done);
+
+      if (joining.load()) {
+        state.notify_one();
+      }
+
+      continue;
+    }
+
+    if (expected == retune) {
+      state.compare_exchange_strong(expected, idle);
+
+      continue;
+    }
+
+    /*
+      Nothing arrived while spinning. The store of sleeping and the load of state inside wait() pair with the store
+      of state and the load of sleeping in post(), so a task posted now can not be missed.
+    */
+
+    sleeping.store(true);
+
+    if (!stop.load()) {
+      state.wait(expected);
+    }
+
+    sleeping.store(false);
+  }
+}
+
+auto ForkJoin::get_n_forks() const -> uint64_t {
+  return n_forks;
+}
+
+auto ForkJoin::get_n_fallbacks() const -> uint64_t {
+  return n_fallbacks;
+}
+
+auto ForkJoin::get_n_late() const -> uint64_t {
+  return n_late;
+}
@@ -80,15 +80,9 @@ void setup(GateBox* self, std::shared_ptr<Gate> gate, const std::string& schema_
   gate->post_messages = true;
   gate->bypass = false;
 
-  self->data->connections.push_back(gate->input_level.connect([=](const float& left, const float& right) {
-    update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                 self->input_level_right_label, left, right);
-  }));
-
-  self->data->connections.push_back(gate->output_level.connect([=](const float& left, const float& right) {
-    update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                 self->output_level_right_label, left, right);
-  }));
+  add_level_meters_tick(GTK_WIDGET(self), gate, self->input_level_left, self->input_level_left_label,
+                        self->input_level_right, self->input_level_right_label, self->output_level_left,
+                        self->output_level_left_label, self->output_level_right, self->output_level_right_label);
 
   self->data->connections.push_back(gate->gating.connect([=](const double& value) {
     gtk_level_bar_set_value(self->gating, 1.0 - value);
@@ -0,0 +1,111 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "link_transaction.hpp"
+
+LinkTransaction::LinkTransaction(PipeManager* pipe_manager)
+    : pm(pipe_manager), start_time(std::chrono::steady_clock::now()) {}
+
+LinkTransaction::~LinkTransaction() {
+  commit();
+}
+
+auto LinkTransaction::link_nodes(const uint& output_node_id,
+                                 const uint& input_node_id,
+                                 std::vector<pw_proxy*>& proxies,
+                                 const bool& probe_link,
+                                 const bool& link_passive) -> uint {
+  const auto pairs = pm->match_ports(output_node_id, input_node_id, probe_link);
+
+  for (const auto& [output_port_id, input_port_id] : pairs) {
+    pending_links.push_back({output_node_id, output_port_id, input_node_id, input_port_id, link_passive, &proxies});
+  }
+
+  return static_cast<uint>(pairs.size());
+}
+
+void LinkTransaction::destroy_object(const uint& id) {
+  pending_objects.push_back(id);
+}
+
+void LinkTransaction::destroy_links(const std::vector<pw_proxy*>& list) {
+  for (auto* proxy : list) {
+    if (proxy != nullptr) {
+      pending_proxies.push_back(proxy);
+    }
+  }
+}
+
+void LinkTransaction::destroy_links_first(const std::vector<pw_proxy*>& list) {
+  for (auto* proxy : list) {
+    if (proxy != nullptr) {
+      early_proxies.push_back(proxy);
+    }
+  }
+}
+
+void LinkTransaction::commit() {
+  if (pending_links.empty() && pending_objects.empty() && pending_proxies.empty() && early_proxies.empty()) {
+    return;
+  }
+
+  const auto n_links = pending_links.size();
+  const auto n_destroyed = pending_objects.size() + pending_proxies.size() + early_proxies.size();
+
+  pm->lock();
+
+  for (auto* proxy : early_proxies) {
+    pw_proxy_destroy(proxy);
+  }
+
+  for (const auto& link : pending_links) {
+    auto* proxy = pm->create_link(link.output_node_id, link.output_port_id, link.input_node_id, link.input_port_id,
+                                  link.passive);
+
+    if (proxy == nullptr) {
+      util::warning(PipeManager::log_tag + "failed to link the node " + util::to_string(link.output_node_id) +
+                    " to " + util::to_string(link.input_node_id));
+
+      continue;
+    }
+
+    link.proxies->push_back(proxy);
+  }
+
+  for (const auto& id : pending_objects) {
+    pw_registry_destroy(pm->registry, id);
+  }
+
+  for (auto* proxy : pending_proxies) {
+    pw_proxy_destroy(proxy);
+  }
+
+  pm->sync_wait_unlock();
+
+  pending_links.clear();
+  pending_objects.clear();
+  pending_proxies.clear();
+  early_proxies.clear();
+
+  const auto elapsed =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+  util::debug(PipeManager::log_tag + "link transaction: " + util::to_string(n_links) + " links created and " +
+              util::to_string(n_destroyed) + " objects destroyed in " + util::to_string(elapsed / 1000.0) + " ms");
+}
@@ -78,15 +78,9 @@ void setup(MaximizerBox* self, std::shared_ptr<Maximizer> maximizer, const std::
   maximizer->post_messages = true;
   maximizer->bypass = false;
 
-  self->data->connections.push_back(maximizer->input_level.connect([=](const float& left, const float& right) {
-    update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                 self->input_level_right_label, left, right);
-  }));
-
-  self->data->connections.push_back(maximizer->output_level.connect([=](const float& left, const float& right) {
-    update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                 self->output_level_right_label, left, right);
-  }));
+  add_level_meters_tick(GTK_WIDGET(self), maximizer, self->input_level_left, self->input_level_left_label,
+                        self->input_level_right, self->input_level_right_label, self->output_level_left,
+                        self->output_level_left_label, self->output_level_right, self->output_level_right_label);
 
   self->data->connections.push_back(maximizer->reduction.connect([=](const double& value) {
     gtk_level_bar_set_value(self->reduction_levelbar, value);
@@ -85,15 +85,9 @@ void setup(MultibandGateBox* self, std::shared_ptr<MultibandGate> multiband_gate
   multiband_gate->post_messages = true;
   multiband_gate->bypass = false;
 
-  self->data->connections.push_back(multiband_gate->input_level.connect([=](const float& left, const float& right) {
-    update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                 self->input_level_right_label, left, right);
-  }));
-
-  self->data->connections.push_back(multiband_gate->output_level.connect([=](const float& left, const float& right) {
-    update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                 self->output_level_right_label, left, right);
-  }));
+  add_level_meters_tick(GTK_WIDGET(self), multiband_gate, self->input_level_left, self->input_level_left_label,
+                        self->input_level_right, self->input_level_right_label, self->output_level_left,
+                        self->output_level_left_label, self->output_level_right, self->output_level_right_label);
 
   self->data->connections.push_back(multiband_gate->output0.connect([=](const double& value) {
     gtk_level_bar_set_value(self->output0, value);
@@ -0,0 +1,218 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "partitioned_convolver.hpp"
+
+PartitionedConvolver::PartitionedConvolver(std::string tag) : log_tag(std::move(tag)), tail_job(this) {}
+
+PartitionedConvolver::~PartitionedConvolver() {
+  ready = false;
+
+  free_buffers();
+}
+
+auto PartitionedConvolver::is_ready() const -> bool {
+  return ready;
+}
+
+auto PartitionedConvolver::get_block_size() const -> uint {
+  return block_size;
+}
+
+void PartitionedConvolver::free_buffers() {
+  // a job that is still queued or running would access the buffers we are about to free
+
+  ConvolverWorkerPool::get().cancel(&tail_job);
+
+  tail_submitted = false;
+
+  if (forward_plan != nullptr) {
+    fftwf_destroy_plan(forward_plan);
+  }
+
+  if (backward_plan != nullptr) {
+    fftwf_destroy_plan(backward_plan);
+  }
+
+  forward_plan = nullptr;
+  backward_plan = nullptr;
+
+  for (auto& c : channels) {
+    for (auto* p : {static_cast<void*>(c.window), static_cast<void*>(c.time_output), static_cast<void*>(c.delay_line),
+                    static_cast<void*>(c.kernel), static_cast<void*>(c.accumulator), static_cast<void*>(c.tail)}) {
+      if (p != nullptr) {
+        fftwf_free(p);
+      }
+    }
+
+    c = Channel{};
+  }
+}
+
+auto PartitionedConvolver::configure(const uint& block_size,
+                                     std::span<const float> kernel_left,
+                                     std::span<const float> kernel_right) -> bool {
+  ready = false;
+
+  free_buffers();
+
+  if (block_size == 0U || kernel_left.empty() || kernel_right.empty()) {
+    return false;
+  }
+
+  this->block_size = block_size;
+
+  /*
+    Each partition of block_size taps is zero padded to 2 * block_size so that the last block_size values of the
+    circular convolution are the linear convolution we want. The bins stride is rounded so that every spectrum in the
+    delay line keeps the alignment fftw had when the plans were made.
+  */
+
+  fft_size = 2U * block_size;
+  n_bins = block_size + 1U;
+  bins_stride = (n_bins + 3U) & ~3U;
+  n_partitions = static_cast<uint>((std::max(kernel_left.size(), kernel_right.size()) + block_size - 1U) / block_size);
+  newest = 0U;
+
+  const auto spectra_size = static_cast<size_t>(n_partitions) * bins_stride;
+
+  for (auto& c : channels) {
+    c.window = fftwf_alloc_real(fft_size);
+    c.time_output = fftwf_alloc_real(fft_size);
+    c.delay_line = fftwf_alloc_complex(spectra_size);
+    c.kernel = fftwf_alloc_complex(spectra_size);
+    c.accumulator = fftwf_alloc_complex(bins_stride);
+    c.tail = fftwf_alloc_complex(bins_stride);
+
+    std::fill_n(c.window, fft_size, 0.0F);
+    std::fill_n(&c.delay_line[0][0], 2U * spectra_size, 0.0F);
+    std::fill_n(&c.kernel[0][0], 2U * spectra_size, 0.0F);
+    std::fill_n(&c.tail[0][0], 2U * bins_stride, 0.0F);
+  }
+
+  forward_plan = fftwf_plan_dft_r2c_1d(static_cast<int>(fft_size), channels[0].window, channels[0].delay_line,
+                                       FFTW_ESTIMATE);
+
+  backward_plan = fftwf_plan_dft_c2r_1d(static_cast<int>(fft_size), channels[0].accumulator, channels[0].time_output,
+                                        FFTW_ESTIMATE);
+
+  if (forward_plan == nullptr || backward_plan == nullptr) {
+    util::warning(log_tag + "could not create the fftw plans");
+
+    free_buffers();
+
+    return false;
+  }
+
+  // fftw does not normalize the inverse transform. We do it once here instead of doing it for every block.
+
+  const float scale = 1.0F / static_cast<float>(fft_size);
+
+  for (size_t ch = 0U; ch < channels.size(); ch++) {
+    const auto kernel = (ch == 0U) ? kernel_left : kernel_right;
+
+    auto& c = channels[ch];
+
+    for (uint p = 0U; p < n_partitions; p++) {
+      const auto first = std::min(static_cast<size_t>(p) * block_size, kernel.size());
+      const auto count = std::min(static_cast<size_t>(block_size), kernel.size() - first);
+
+      std::fill_n(c.time_output, fft_size, 0.0F);
+
+      for (size_t m = 0U; m < count; m++) {
+        c.time_output[m] = kernel[first + m] * scale;
+      }
+
+      fftwf_execute_dft_r2c(forward_plan, c.time_output, c.kernel + static_cast<size_t>(p) * bins_stride);
+    }
+  }
+
+  ready = true;
+
+  util::debug(log_tag + "block size: " + util::to_string(block_size) +
+              ", partitions: " + util::to_string(n_partitions));
+
+  return true;
+}
+
+void PartitionedConvolver::process(std::span<float> data_left, std::span<float> data_right) {
+  if (!ready) {
+    return;
+  }
+
+  // the new block goes to the slot of the oldest one. The tail job never reads it
+
+  newest = (newest + n_partitions - 1U) % n_partitions;
+
+  for (size_t ch = 0U; ch < channels.size(); ch++) {
+    auto& c = channels[ch];
+
+    const auto data = (ch == 0U) ? data_left : data_right;
+
+    std::copy_n(c.window + block_size, block_size, c.window);
+    std::copy_n(data.begin(), block_size, c.window + block_size);
+
+    fftwf_execute_dft_r2c(forward_plan, c.window, c.delay_line + static_cast<size_t>(newest) * bins_stride);
+  }
+
+  if (tail_submitted) {
+    ConvolverWorkerPool::get().wait(&tail_job);
+  }
+
+  for (size_t ch = 0U; ch < channels.size(); ch++) {
+    auto& c = channels[ch];
+
+    if (tail_submitted) {
+      std::copy_n(&c.tail[0][0], 2U * n_bins, &c.accumulator[0][0]);
+    } else {
+      std::fill_n(&c.accumulator[0][0], 2U * n_bins, 0.0F);
+    }
+
+    multiply_accumulate(c.delay_line + static_cast<size_t>(newest) * bins_stride, c.kernel, c.accumulator, n_bins);
+
+    fftwf_execute_dft_c2r(backward_plan, c.accumulator, c.time_output);
+
+    auto data = (ch == 0U) ? data_left : data_right;
+
+    std::copy_n(c.time_output + block_size, block_size, data.begin());
+  }
+
+  // the contribution of the older partitions to the next block can be computed in advance
+
+  if (n_partitions > 1U) {
+    tail_base = newest;
+
+    ConvolverWorkerPool::get().submit(&tail_job);
+
+    tail_submitted = true;
+  }
+}
+
+void PartitionedConvolver::compute_tail() {
+  for (auto& c : channels) {
+    std::fill_n(&c.tail[0][0], 2U * n_bins, 0.0F);
+
+    for (uint p = 1U; p < n_partitions; p++) {
+      const auto slot = (tail_base + p - 1U) % n_partitions;
+
+      multiply_accumulate(c.delay_line + static_cast<size_t>(slot) * bins_stride,
+                          c.kernel + static_cast<size_t>(p) * bins_stride, c.tail, n_bins);
+    }
+  }
+}
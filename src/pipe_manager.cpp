@@ -18,6 +18,7 @@
  */
 
 #include "pipe_manager.hpp"
+#include "link_transaction.hpp"
 
 namespace {
 
@@ -44,6 +45,8 @@ struct proxy_data {
 
   uint id = SPA_ID_INVALID;
 
+  uint node_id = SPA_ID_INVALID;  // only used by ports
+
   uint64_t serial = SPA_ID_INVALID;
 };
 
@@ -97,6 +100,26 @@ auto link_info_from_props(const spa_dict* props) -> LinkInfo {
   return info;
 }
 
+auto audio_channel_from_name(const char* name) -> AudioChannel {
+  if (g_strcmp0(name, "FL") == 0) {
+    return AudioChannel::FL;
+  }
+
+  if (g_strcmp0(name, "FR") == 0) {
+    return AudioChannel::FR;
+  }
+
+  if (g_strcmp0(name, "PROBE_FL") == 0) {
+    return AudioChannel::PROBE_FL;
+  }
+
+  if (g_strcmp0(name, "PROBE_FR") == 0) {
+    return AudioChannel::PROBE_FR;
+  }
+
+  return AudioChannel::other;
+}
+
 auto port_info_from_props(const spa_dict* props) -> PortInfo {
   PortInfo info;
 
@@ -117,11 +140,16 @@ auto port_info_from_props(const spa_dict* props) -> PortInfo {
   }
 
   if (const auto* direction = spa_dict_lookup(props, PW_KEY_PORT_DIRECTION)) {
-    info.direction = direction;
+    if (g_strcmp0(direction, "in") == 0) {
+      info.direction = PortDirection::input;
+    } else if (g_strcmp0(direction, "out") == 0) {
+      info.direction = PortDirection::output;
+    }
   }
 
   if (const auto* port_channel = spa_dict_lookup(props, PW_KEY_AUDIO_CHANNEL)) {
     info.audio_channel = port_channel;
+    info.channel = audio_channel_from_name(port_channel);
   }
 
   if (const auto* port_audio_format = spa_dict_lookup(props, PW_KEY_AUDIO_FORMAT)) {
@@ -694,25 +722,29 @@ void on_link_info(void* object, const struct pw_link_info* info) {
 
   LinkInfo link_copy;
 
-  for (auto& l : ld->pm->list_links) {
-    if (l.serial == ld->serial) {
-      l.state = info->state;
+  {
+    std::scoped_lock<std::mutex> lock(pm->graph_mutex);
 
-      link_copy = l;
+    auto it = pm->link_map.find(ld->serial);
 
-      util::idle_add([pm, link_copy] {
-        if (PipeManager::exiting) {
-          return;
-        }
+    if (it == pm->link_map.end()) {
+      return;
+    }
 
-        pm->link_changed.emit(link_copy);
-      });
+    it->second.state = info->state;
 
-      // util::warning(pw_link_state_as_string(l.state));
+    link_copy = it->second;
+  }
 
-      break;
+  util::idle_add([pm, link_copy] {
+    if (PipeManager::exiting) {
+      return;
     }
-  }
+
+    pm->link_changed.emit(link_copy);
+  });
+
+  // util::warning(pw_link_state_as_string(link_copy.state));
 
   // const struct spa_dict_item* item = nullptr;
   // spa_dict_for_each(item, info->props) printf("\t\t%s: \"%s\"\n", item->key, item->value);
@@ -723,9 +755,27 @@ void on_destroy_link_proxy(void* data) {
 
   spa_hook_remove(&ld->proxy_listener);
 
-  ld->pm->list_links.erase(std::remove_if(ld->pm->list_links.begin(), ld->pm->list_links.end(),
-                                          [=](const auto& n) { return n.serial == ld->serial; }),
-                           ld->pm->list_links.end());
+  auto* const pm = ld->pm;
+
+  std::scoped_lock<std::mutex> lock(pm->graph_mutex);
+
+  auto it = pm->link_map.find(ld->serial);
+
+  if (it == pm->link_map.end()) {
+    return;
+  }
+
+  for (const auto& node_id : {it->second.input_node_id, it->second.output_node_id}) {
+    if (auto node = pm->node_links.find(node_id); node != pm->node_links.end()) {
+      std::erase(node->second, ld->serial);
+
+      if (node->second.empty()) {
+        pm->node_links.erase(node);
+      }
+    }
+  }
+
+  pm->link_map.erase(it);
 }
 
 void on_destroy_port_proxy(void* data) {
@@ -733,9 +783,17 @@ void on_destroy_port_proxy(void* data) {
 
   spa_hook_remove(&pd->proxy_listener);
 
-  pd->pm->list_ports.erase(std::remove_if(pd->pm->list_ports.begin(), pd->pm->list_ports.end(),
-                                          [=](const auto& n) { return n.serial == pd->serial; }),
-                           pd->pm->list_ports.end());
+  auto* const pm = pd->pm;
+
+  std::scoped_lock<std::mutex> lock(pm->graph_mutex);
+
+  if (auto node = pm->node_ports.find(pd->node_id); node != pm->node_ports.end()) {
+    std::erase_if(node->second, [=](const auto& port) { return port.serial == pd->serial; });
+
+    if (node->second.empty()) {
+      pm->node_ports.erase(node);
+    }
+  }
 }
 
 void on_module_info(void* object, const struct pw_module_info* info) {
@@ -1260,7 +1318,17 @@ void on_registry_global(void* data,
     link_info.id = id;
     link_info.serial = serial;
 
-    pm->list_links.push_back(link_info);
+    {
+      std::scoped_lock<std::mutex> lock(pm->graph_mutex);
+
+      pm->link_map[serial] = link_info;
+
+      pm->node_links[link_info.input_node_id].push_back(serial);
+
+      if (link_info.output_node_id != link_info.input_node_id) {
+        pm->node_links[link_info.output_node_id].push_back(serial);
+      }
+    }
 
     try {
       const auto input_node = pm->node_map_at_id(link_info.input_node_id);
@@ -1306,10 +1374,18 @@ void on_registry_global(void* data,
     port_info.id = id;
     port_info.serial = serial;
 
-    // std::cout << port_info.name << "\t" << port_info.audio_channel << "\t" << port_info.direction << "\t"
-    //           << port_info.format_dsp << "\t" << port_info.port_id << "\t" << port_info.node_id << std::endl;
+    pd->node_id = port_info.node_id;
 
-    pm->list_ports.push_back(port_info);
+    // std::cout << port_info.name << "\t" << port_info.audio_channel << "\t" << port_info.format_dsp << "\t"
+    //           << port_info.port_id << "\t" << port_info.node_id << std::endl;
+
+    {
+      std::scoped_lock<std::mutex> lock(pm->graph_mutex);
+
+      pm->node_ports[port_info.node_id].push_back(port_info);
+    }
+
+    pm->graph_cv.notify_all();
 
     return;
   }
@@ -1664,14 +1740,22 @@ auto PipeManager::node_map_at_id(const uint& id) -> NodeInfo& {
 }
 
 auto PipeManager::stream_is_connected(const uint& id, const std::string& media_class) -> bool {
-  if (media_class == media_class_output_stream) {
-    for (const auto& link : list_links) {
+  std::scoped_lock<std::mutex> lock(graph_mutex);
+
+  auto it = node_links.find(id);
+
+  if (it == node_links.end()) {
+    return false;
+  }
+
+  for (const auto& serial : it->second) {
+    const auto& link = link_map.at(serial);
+
+    if (media_class == media_class_output_stream) {
       if (link.output_node_id == id && link.input_node_id == ee_sink_node.id) {
         return true;
       }
-    }
-  } else if (media_class == media_class_input_stream) {
-    for (const auto& link : list_links) {
+    } else if (media_class == media_class_input_stream) {
       if (link.output_node_id == ee_source_node.id && link.input_node_id == id) {
         return true;
       }
@@ -1738,15 +1822,46 @@ void PipeManager::set_node_mute(pw_proxy* proxy, const bool& state) {
 }
 
 auto PipeManager::count_node_ports(const uint& node_id) -> uint {
-  uint count = 0;
+  std::scoped_lock<std::mutex> lock(graph_mutex);
+
+  auto it = node_ports.find(node_id);
 
-  for (const auto& port : list_ports) {
-    if (port.node_id == node_id) {
-      count++;
+  return (it != node_ports.end()) ? static_cast<uint>(it->second.size()) : 0U;
+}
+
+auto PipeManager::get_node_ports(const uint& node_id) -> std::vector<PortInfo> {
+  std::scoped_lock<std::mutex> lock(graph_mutex);
+
+  auto it = node_ports.find(node_id);
+
+  return (it != node_ports.end()) ? it->second : std::vector<PortInfo>();
+}
+
+auto PipeManager::get_node_links(const uint& node_id) -> std::vector<LinkInfo> {
+  std::vector<LinkInfo> list;
+
+  std::scoped_lock<std::mutex> lock(graph_mutex);
+
+  if (auto it = node_links.find(node_id); it != node_links.end()) {
+    list.reserve(it->second.size());
+
+    for (const auto& serial : it->second) {
+      list.push_back(link_map.at(serial));
     }
   }
 
-  return count;
+  return list;
+}
+
+auto PipeManager::wait_node_ports(const uint& node_id, const uint& n_ports, const std::chrono::milliseconds& timeout)
+    -> bool {
+  std::unique_lock<std::mutex> lock(graph_mutex);
+
+  return graph_cv.wait_for(lock, timeout, [&] {
+    auto it = node_ports.find(node_id);
+
+    return it != node_ports.end() && it->second.size() >= n_ports;
+  });
 }
 
 auto PipeManager::link_nodes(const uint& output_node_id,
@@ -1754,33 +1869,50 @@ auto PipeManager::link_nodes(const uint& output_node_id,
                              const bool& probe_link,
                              const bool& link_passive) -> std::vector<pw_proxy*> {
   std::vector<pw_proxy*> list;
+
+  LinkTransaction transaction(this);
+
+  transaction.link_nodes(output_node_id, input_node_id, list, probe_link, link_passive);
+
+  transaction.commit();
+
+  return list;
+}
+
+auto PipeManager::match_ports(const uint& output_node_id, const uint& input_node_id, const bool& probe_link)
+    -> std::vector<std::pair<uint, uint>> {
+  std::vector<std::pair<uint, uint>> list;
   std::vector<PortInfo> list_output_ports;
   std::vector<PortInfo> list_input_ports;
   auto use_audio_channel = true;
 
-  for (const auto& port : list_ports) {
-    if (port.node_id == output_node_id && port.direction == "out") {
+  const auto is_stereo = [](const PortInfo& port) {
+    return port.channel == AudioChannel::FL || port.channel == AudioChannel::FR;
+  };
+
+  for (const auto& port : get_node_ports(output_node_id)) {
+    if (port.direction == PortDirection::output) {
       list_output_ports.push_back(port);
 
-      if (!probe_link) {
-        if (port.audio_channel != "FL" && port.audio_channel != "FR") {
-          use_audio_channel = false;
-        }
+      if (!probe_link && !is_stereo(port)) {
+        use_audio_channel = false;
       }
     }
+  }
 
-    if (port.node_id == input_node_id && port.direction == "in") {
-      if (!probe_link) {
-        list_input_ports.push_back(port);
+  for (const auto& port : get_node_ports(input_node_id)) {
+    if (port.direction != PortDirection::input) {
+      continue;
+    }
 
-        if (port.audio_channel != "FL" && port.audio_channel != "FR") {
-          use_audio_channel = false;
-        }
-      } else {
-        if (port.audio_channel == "PROBE_FL" || port.audio_channel == "PROBE_FR") {
-          list_input_ports.push_back(port);
-        }
+    if (!probe_link) {
+      list_input_ports.push_back(port);
+
+      if (!is_stereo(port)) {
+        use_audio_channel = false;
       }
+    } else if (port.channel == AudioChannel::PROBE_FL || port.channel == AudioChannel::PROBE_FR) {
+      list_input_ports.push_back(port);
     }
   }
 
@@ -1802,54 +1934,44 @@ auto PipeManager::link_nodes(const uint& output_node_id,
 
       if (!probe_link) {
         if (use_audio_channel) {
-          ports_match = outp.audio_channel == inp.audio_channel;
+          ports_match = outp.channel == inp.channel;
         } else {
           ports_match = outp.port_id == inp.port_id;
         }
       } else {
-        if (outp.audio_channel == "FL" && inp.audio_channel == "PROBE_FL") {
-          ports_match = true;
-        }
-
-        if (outp.audio_channel == "FR" && inp.audio_channel == "PROBE_FR") {
-          ports_match = true;
-        }
+        ports_match = (outp.channel == AudioChannel::FL && inp.channel == AudioChannel::PROBE_FL) ||
+                      (outp.channel == AudioChannel::FR && inp.channel == AudioChannel::PROBE_FR);
       }
 
       if (ports_match) {
-        pw_properties* props = pw_properties_new(nullptr, nullptr);
-
-        pw_properties_set(props, PW_KEY_LINK_PASSIVE, (link_passive) ? "true" : "false");
-        pw_properties_set(props, PW_KEY_OBJECT_LINGER, "false");
-        pw_properties_set(props, PW_KEY_LINK_OUTPUT_NODE, util::to_string(output_node_id).c_str());
-        pw_properties_set(props, PW_KEY_LINK_OUTPUT_PORT, util::to_string(outp.id).c_str());
-        pw_properties_set(props, PW_KEY_LINK_INPUT_NODE, util::to_string(input_node_id).c_str());
-        pw_properties_set(props, PW_KEY_LINK_INPUT_PORT, util::to_string(inp.id).c_str());
-
-        lock();
-
-        auto* proxy = static_cast<pw_proxy*>(
-            pw_core_create_object(core, "link-factory", PW_TYPE_INTERFACE_Link, PW_VERSION_LINK, &props->dict, 0));
-
-        pw_properties_free(props);
+        list.emplace_back(outp.id, inp.id);
+      }
+    }
+  }
 
-        if (proxy == nullptr) {
-          util::warning(log_tag + "failed to link the node " + util::to_string(output_node_id) + " to " +
-                        util::to_string(input_node_id));
+  return list;
+}
 
-          unlock();
+auto PipeManager::create_link(const uint& output_node_id,
+                              const uint& output_port_id,
+                              const uint& input_node_id,
+                              const uint& input_port_id,
+                              const bool& link_passive) const -> pw_proxy* {
+  pw_properties* props = pw_properties_new(nullptr, nullptr);
 
-          return list;
-        }
+  pw_properties_set(props, PW_KEY_LINK_PASSIVE, (link_passive) ? "true" : "false");
+  pw_properties_set(props, PW_KEY_OBJECT_LINGER, "false");
+  pw_properties_set(props, PW_KEY_LINK_OUTPUT_NODE, util::to_string(output_node_id).c_str());
+  pw_properties_set(props, PW_KEY_LINK_OUTPUT_PORT, util::to_string(output_port_id).c_str());
+  pw_properties_set(props, PW_KEY_LINK_INPUT_NODE, util::to_string(input_node_id).c_str());
+  pw_properties_set(props, PW_KEY_LINK_INPUT_PORT, util::to_string(input_port_id).c_str());
 
-        sync_wait_unlock();
+  auto* proxy = static_cast<pw_proxy*>(
+      pw_core_create_object(core, "link-factory", PW_TYPE_INTERFACE_Link, PW_VERSION_LINK, &props->dict, 0));
 
-        list.push_back(proxy);
-      }
-    }
-  }
+  pw_properties_free(props);
 
-  return list;
+  return proxy;
 }
 
 void PipeManager::lock() const {
@@ -1877,15 +1999,19 @@ void PipeManager::destroy_object(const int& id) const {
 }
 
 void PipeManager::destroy_links(const std::vector<pw_proxy*>& list) const {
+  if (list.empty()) {
+    return;
+  }
+
+  lock();
+
   for (auto* proxy : list) {
     if (proxy != nullptr) {
-      lock();
-
       pw_proxy_destroy(proxy);
-
-      sync_wait_unlock();
     }
   }
+
+  sync_wait_unlock();
 }
 
 /*
@@ -135,6 +135,8 @@ Pitch::Pitch(const std::string& tag,
                                           this));
 
   setup_input_output_gain();
+
+  builder = std::thread(&Pitch::build_loop, this);
 }
 
 Pitch::~Pitch() {
@@ -142,32 +144,106 @@ Pitch::~Pitch() {
     disconnect_from_pw();
   }
 
+  {
+    std::scoped_lock<std::mutex> lock(builder_mutex);
+
+    builder_quit = true;
+  }
+
+  builder_cv.notify_one();
+
+  builder.join();
+
   util::debug(log_tag + name + " destroyed");
 }
 
 void Pitch::setup() {
+  data_mutex.lock();
+
   rubberband_ready = false;
 
   latency_n_frames = 0U;
 
-  deque_out_L.resize(0);
-  deque_out_R.resize(0);
+  /*
+    RubberBand may hand back a few hops at once, so the ring gets some headroom over the quantum.
+  */
+
+  const auto ring_size = std::max(static_cast<size_t>(n_samples) * 4U, static_cast<size_t>(8192U));
+
+  ring_L.resize(ring_size);
+  ring_R.resize(ring_size);
+
+  reset_ring();
+
+  const auto generation = ++stretcher_generation;
+
+  data_mutex.unlock();
 
   /*
-   RubberBand initialization is slow. It is better to do it outside of the plugin realtime thread
+   RubberBand initialization is slow. The new stretcher is built by the builder thread and only swapped in once it is
+   ready. The generation counter discards instances that were superseded while they were being built.
  */
 
-  util::idle_add([&, this] {
-    if (rubberband_ready) {
+  {
+    std::scoped_lock<std::mutex> lock(builder_mutex);
+
+    build_requested = true;
+    build_rate = rate;
+    build_size = n_samples;
+    build_generation = generation;
+  }
+
+  builder_cv.notify_one();
+}
+
+void Pitch::build_loop() {
+  std::unique_lock<std::mutex> lock(builder_mutex);
+
+  while (true) {
+    builder_cv.wait(lock, [this] { return builder_quit || build_requested; });
+
+    if (builder_quit) {
       return;
     }
 
-    init_stretcher();
+    build_requested = false;
+
+    const auto generation = build_generation;
+    const auto sampling_rate = build_rate;
+    const auto max_process_size = build_size;
+
+    // The lock is only held to read the request. setup() never waits for a build.
+
+    lock.unlock();
+
+    auto new_stretcher = build_stretcher(sampling_rate, max_process_size);
+
+    {
+      std::scoped_lock<std::mutex> data_lock(data_mutex);
+
+      if (generation == stretcher_generation) {
+        // Options may have changed while the instance was being built
+
+        apply_options(*new_stretcher);
+
+        stretcher.swap(new_stretcher);
+
+        reset_ring();
+
+        latency_n_frames = static_cast<uint>(stretcher->getLatency());
+
+        notify_latency = true;
+
+        rubberband_ready = true;
+      }
+    }
+
+    // The replaced instance is freed here, outside of both locks
 
-    std::scoped_lock<std::mutex> lock(data_mutex);
+    new_stretcher.reset();
 
-    rubberband_ready = true;
-  });
+    lock.lock();
+  }
 }
 
 void Pitch::process(std::span<float>& left_in,
@@ -190,58 +266,48 @@ void Pitch::process(std::span<float>& left_in,
   stretcher_in[0] = left_in.data();
   stretcher_in[1] = right_in.data();
 
-  stretcher->process(stretcher_in.data(), n_samples, false);
+  stretcher->process(stretcher_in.data(), left_in.size(), false);
 
-  if (const auto n_available = stretcher->available(); n_available > 0) {
-    // util::debug(log_tag + name + " available: " + util::to_string(n_available));
+  // Retrieving straight into the ring. Whatever does not fit stays queued inside the stretcher.
 
-    data_L.resize(n_available);
-    data_R.resize(n_available);
+  const auto ring_size = ring_L.size();
 
-    stretcher_out[0] = data_L.data();
-    stretcher_out[1] = data_R.data();
+  for (auto n_available = stretcher->available(); n_available > 0 && ring_count < ring_size;
+       n_available = stretcher->available()) {
+    const auto n_chunk =
+        std::min({static_cast<size_t>(n_available), ring_size - ring_count, ring_size - ring_write});
 
-    stretcher->retrieve(stretcher_out.data(), n_available);
+    stretcher_out[0] = ring_L.data() + ring_write;
+    stretcher_out[1] = ring_R.data() + ring_write;
 
-    for (int n = 0; n < n_available; n++) {
-      deque_out_L.push_back(data_L[n]);
-      deque_out_R.push_back(data_R[n]);
-    }
+    stretcher->retrieve(stretcher_out.data(), n_chunk);
+
+    ring_write = (ring_write + n_chunk) % ring_size;
+    ring_count += n_chunk;
   }
 
-  if (deque_out_L.size() >= left_out.size()) {
-    for (float& v : left_out) {
-      v = deque_out_L.front();
+  /*
+    Underruns are only expected while the stretcher is filling up. Silence goes first so that the output stays
+    aligned with the latency reported by RubberBand.
+  */
 
-      deque_out_L.pop_front();
-    }
+  const auto n_out = left_out.size();
 
-    for (float& v : right_out) {
-      v = deque_out_R.front();
+  const auto offset = (ring_count < n_out) ? n_out - ring_count : 0U;
 
-      deque_out_R.pop_front();
-    }
-  } else {
-    const uint offset = left_out.size() - deque_out_L.size();
+  std::fill(left_out.begin(), left_out.begin() + offset, 0.0F);
+  std::fill(right_out.begin(), right_out.begin() + offset, 0.0F);
 
-    if (offset != latency_n_frames) {
-      latency_n_frames = offset;
+  for (size_t n = offset; n < n_out;) {
+    const auto n_chunk = std::min(n_out - n, ring_size - ring_read);
 
-      notify_latency = true;
-    }
+    std::copy_n(ring_L.begin() + ring_read, n_chunk, left_out.begin() + n);
+    std::copy_n(ring_R.begin() + ring_read, n_chunk, right_out.begin() + n);
 
-    for (uint n = 0U; !deque_out_L.empty() && n < left_out.size(); n++) {
-      if (n < offset) {
-        left_out[n] = 0.0F;
-        right_out[n] = 0.0F;
-      } else {
-        left_out[n] = deque_out_L.front();
-        right_out[n] = deque_out_R.front();
+    ring_read = (ring_read + n_chunk) % ring_size;
+    ring_count -= n_chunk;
 
-        deque_out_R.pop_front();
-        deque_out_L.pop_front();
-      }
-    }
+    n += n_chunk;
   }
 
   if (output_gain != 1.0F) {
@@ -261,24 +327,6 @@ void Pitch::process(std::span<float>& left_in,
       latency.emit(latency_value);
     });
 
-    g_idle_add((GSourceFunc) +
-                   [](gpointer user_data) {
-                     if (!post_messages) {
-                       return G_SOURCE_REMOVE;
-                     }
-
-                     auto* self = static_cast<Pitch*>(user_data);
-
-                     if (self->latency.empty()) {
-                       return G_SOURCE_REMOVE;
-                     }
-
-                     self->latency.emit(self->latency_value);
-
-                     return G_SOURCE_REMOVE;
-                   },
-               this);
-
     spa_process_latency_info latency_info{};
 
     latency_info.ns = static_cast<uint64_t>(latency_value * 1000000000.0F);
@@ -309,6 +357,12 @@ void Pitch::process(std::span<float>& left_in,
   }
 }
 
+void Pitch::reset_ring() {
+  ring_read = 0U;
+  ring_write = 0U;
+  ring_count = 0U;
+}
+
 /*
   Code based on the RubberBand LADSPA plugin
 
@@ -388,143 +442,162 @@ auto Pitch::parse_phase_key(const std::string& key) -> Phase {
 }
 
 void Pitch::set_mode() {
-  if (stretcher == nullptr) {
-    return;
+  std::scoped_lock<std::mutex> lock(data_mutex);
+
+  if (stretcher != nullptr) {
+    apply_mode(*stretcher);
+  }
+}
+
+void Pitch::set_formant() {
+  std::scoped_lock<std::mutex> lock(data_mutex);
+
+  if (stretcher != nullptr) {
+    apply_formant(*stretcher);
   }
+}
 
+void Pitch::set_transients() {
   std::scoped_lock<std::mutex> lock(data_mutex);
 
+  if (stretcher != nullptr) {
+    apply_transients(*stretcher);
+  }
+}
+
+void Pitch::set_detector() {
+  std::scoped_lock<std::mutex> lock(data_mutex);
+
+  if (stretcher != nullptr) {
+    apply_detector(*stretcher);
+  }
+}
+
+void Pitch::set_phase() {
+  std::scoped_lock<std::mutex> lock(data_mutex);
+
+  if (stretcher != nullptr) {
+    apply_phase(*stretcher);
+  }
+}
+
+void Pitch::set_pitch_scale() {
+  std::scoped_lock<std::mutex> lock(data_mutex);
+
+  if (stretcher != nullptr) {
+    apply_pitch_scale(*stretcher);
+  }
+}
+
+void Pitch::apply_mode(RubberBand::RubberBandStretcher& s) const {
   switch (mode) {
     case Mode::speed:
-      stretcher->setPitchOption(RubberBand::RubberBandStretcher::OptionPitchHighSpeed);
+      s.setPitchOption(RubberBand::RubberBandStretcher::OptionPitchHighSpeed);
 
       break;
     case Mode::quality:
-      stretcher->setPitchOption(RubberBand::RubberBandStretcher::OptionPitchHighQuality);
+      s.setPitchOption(RubberBand::RubberBandStretcher::OptionPitchHighQuality);
 
       break;
     case Mode::consistency:
-      stretcher->setPitchOption(RubberBand::RubberBandStretcher::OptionPitchHighConsistency);
+      s.setPitchOption(RubberBand::RubberBandStretcher::OptionPitchHighConsistency);
 
       break;
   }
 }
 
-void Pitch::set_formant() {
-  if (stretcher == nullptr) {
-    return;
-  }
-
-  std::scoped_lock<std::mutex> lock(data_mutex);
-
+void Pitch::apply_formant(RubberBand::RubberBandStretcher& s) const {
   switch (formant) {
     case Formant::shifted:
-      stretcher->setFormantOption(RubberBand::RubberBandStretcher::OptionFormantShifted);
+      s.setFormantOption(RubberBand::RubberBandStretcher::OptionFormantShifted);
 
       break;
     case Formant::preserved:
-      stretcher->setFormantOption(RubberBand::RubberBandStretcher::OptionFormantPreserved);
+      s.setFormantOption(RubberBand::RubberBandStretcher::OptionFormantPreserved);
 
       break;
   }
 }
 
-void Pitch::set_transients() {
-  if (stretcher == nullptr) {
-    return;
-  }
-
-  std::scoped_lock<std::mutex> lock(data_mutex);
-
+void Pitch::apply_transients(RubberBand::RubberBandStretcher& s) const {
   switch (transients) {
     case Transients::crisp:
-      stretcher->setTransientsOption(RubberBand::RubberBandStretcher::OptionTransientsCrisp);
+      s.setTransientsOption(RubberBand::RubberBandStretcher::OptionTransientsCrisp);
 
       break;
     case Transients::mixed:
-      stretcher->setTransientsOption(RubberBand::RubberBandStretcher::OptionTransientsMixed);
+      s.setTransientsOption(RubberBand::RubberBandStretcher::OptionTransientsMixed);
 
       break;
     case Transients::smooth:
-      stretcher->setTransientsOption(RubberBand::RubberBandStretcher::OptionTransientsSmooth);
+      s.setTransientsOption(RubberBand::RubberBandStretcher::OptionTransientsSmooth);
 
       break;
   }
 }
 
-void Pitch::set_detector() {
-  if (stretcher == nullptr) {
-    return;
-  }
-
-  std::scoped_lock<std::mutex> lock(data_mutex);
-
+void Pitch::apply_detector(RubberBand::RubberBandStretcher& s) const {
   switch (detector) {
     case Detector::compound:
-      stretcher->setDetectorOption(RubberBand::RubberBandStretcher::OptionDetectorCompound);
+      s.setDetectorOption(RubberBand::RubberBandStretcher::OptionDetectorCompound);
 
       break;
     case Detector::percussive:
-      stretcher->setDetectorOption(RubberBand::RubberBandStretcher::OptionDetectorPercussive);
+      s.setDetectorOption(RubberBand::RubberBandStretcher::OptionDetectorPercussive);
 
       break;
     case Detector::soft:
-      stretcher->setTransientsOption(RubberBand::RubberBandStretcher::OptionDetectorSoft);
+      s.setDetectorOption(RubberBand::RubberBandStretcher::OptionDetectorSoft);
 
       break;
   }
 }
 
-void Pitch::set_phase() {
-  if (stretcher == nullptr) {
-    return;
-  }
-
-  std::scoped_lock<std::mutex> lock(data_mutex);
-
+void Pitch::apply_phase(RubberBand::RubberBandStretcher& s) const {
   switch (phase) {
     case Phase::laminar:
-      stretcher->setPhaseOption(RubberBand::RubberBandStretcher::OptionPhaseLaminar);
+      s.setPhaseOption(RubberBand::RubberBandStretcher::OptionPhaseLaminar);
 
       break;
     case Phase::independent:
-      stretcher->setPhaseOption(RubberBand::RubberBandStretcher::OptionPhaseIndependent);
+      s.setPhaseOption(RubberBand::RubberBandStretcher::OptionPhaseIndependent);
 
       break;
   }
 }
 
-void Pitch::set_pitch_scale() {
-  if (stretcher == nullptr) {
-    return;
-  }
-
-  std::scoped_lock<std::mutex> lock(data_mutex);
-
+void Pitch::apply_pitch_scale(RubberBand::RubberBandStretcher& s) const {
   const double n_octaves = octaves + (static_cast<double>(semitones) / 12.0) + (static_cast<double>(cents) / 1200.0);
 
   const double ratio = std::pow(2.0, n_octaves);
 
-  stretcher->setPitchScale(ratio);
+  s.setPitchScale(ratio);
 }
 
-void Pitch::init_stretcher() {
-  delete stretcher;
+void Pitch::apply_options(RubberBand::RubberBandStretcher& s) const {
+  apply_pitch_scale(s);
+  apply_mode(s);
+  apply_formant(s);
+  apply_transients(s);
+  apply_detector(s);
+  apply_phase(s);
+}
 
+auto Pitch::build_stretcher(const uint& sampling_rate, const uint& max_process_size)
+    -> std::unique_ptr<RubberBand::RubberBandStretcher> {
   RubberBand::RubberBandStretcher::Options options =
       RubberBand::RubberBandStretcher::OptionProcessRealTime | RubberBand::RubberBandStretcher::OptionChannelsTogether;
 
-  stretcher = new RubberBand::RubberBandStretcher(rate, 2, options);
+  auto s = std::make_unique<RubberBand::RubberBandStretcher>(sampling_rate, 2, options);
+
+  // Preallocating for the largest block we will ever hand over keeps process() from allocating
+
+  s->setMaxProcessSize(max_process_size);
+  s->setTimeRatio(time_ratio);
 
-  stretcher->setMaxProcessSize(n_samples);
-  stretcher->setTimeRatio(time_ratio);
+  apply_options(*s);
 
-  set_pitch_scale();
-  set_mode();
-  set_formant();
-  set_transients();
-  set_detector();
-  set_phase();
+  return s;
 }
 
 auto Pitch::get_latency_seconds() -> float {
@@ -42,6 +42,9 @@ void on_process(void* userdata, spa_io_position* position) {
     std::ranges::fill(d->pb->dummy_left, 0.0F);
     std::ranges::fill(d->pb->dummy_right, 0.0F);
 
+    d->pb->input_tap->set_rate(rate, n_samples);
+    d->pb->output_tap->set_rate(rate, n_samples);
+
     d->pb->setup();
   }
 
@@ -79,6 +82,10 @@ void on_process(void* userdata, spa_io_position* position) {
     right_out = d->pb->dummy_right;
   }
 
+  // Plugins may apply their input gain in place, so the input tap has to be fed before process()
+
+  d->pb->input_tap->push(left_in, right_in);
+
   if (!d->pb->enable_probe) {
     d->pb->process(left_in, right_in, left_out, right_out);
   } else {
@@ -97,6 +104,8 @@ void on_process(void* userdata, spa_io_position* position) {
       d->pb->process(left_in, right_in, left_out, right_out, l, r);
     }
   }
+
+  d->pb->output_tap->push(left_out, right_out);
 }
 
 const struct pw_filter_events filter_events = {.process = on_process};
@@ -116,6 +125,9 @@ PluginBase::PluginBase(std::string tag,
       pm(pipe_manager) {
   pf_data.pb = this;
 
+  input_tap = SpectrumAnalyzer::create_tap();
+  output_tap = SpectrumAnalyzer::create_tap();
+
   const auto filter_name = "ee_" + log_tag.substr(0, log_tag.size() - 2U) + "_" + name;
 
   pm->lock();
@@ -254,11 +266,11 @@ auto PluginBase::connect_to_pw() -> bool {
 
     /*
       The filter we link in our pipeline have at least 4 ports. Some have six. Before we try to link filters we have to
-      wait until the information about their ports is available in PipeManager's list_ports vector.
+      wait until the information about their ports is available in PipeManager's node_ports table.
     */
 
-    while (pm->count_node_ports(node_id) != n_ports) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (!pm->wait_node_ports(node_id, n_ports, PipeManager::ports_timeout)) {
+      util::warning(log_tag + name + " ports are taking too long to show up in the PipeWire graph");
     }
 
     initialize_listener();
@@ -380,22 +392,13 @@ void PluginBase::apply_gain(std::span<float>& left, std::span<float>& right, con
 }
 
 void PluginBase::notify() {
-  const auto input_peak_db_l = util::linear_to_db(input_peak_left);
-  const auto input_peak_db_r = util::linear_to_db(input_peak_right);
-
-  const auto output_peak_db_l = util::linear_to_db(output_peak_left);
-  const auto output_peak_db_r = util::linear_to_db(output_peak_right);
+  input_peak_db_left.store(util::linear_to_db(input_peak_left), std::memory_order_relaxed);
+  input_peak_db_right.store(util::linear_to_db(input_peak_right), std::memory_order_relaxed);
 
-  util::idle_add([=, this]() {
-    // The application was hanging when we finished it. This seems to fix the problem.
-
-    if (!post_messages) {
-      return;
-    }
+  output_peak_db_left.store(util::linear_to_db(output_peak_left), std::memory_order_relaxed);
+  output_peak_db_right.store(util::linear_to_db(output_peak_right), std::memory_order_relaxed);
 
-    input_level.emit(input_peak_db_l, input_peak_db_r);
-    output_level.emit(output_peak_db_l, output_peak_db_r);
-  });
+  levels_serial.fetch_add(1U, std::memory_order_release);
 
   input_peak_left = util::minimum_linear_level;
   input_peak_right = util::minimum_linear_level;
@@ -403,4 +406,23 @@ void PluginBase::notify() {
   output_peak_right = util::minimum_linear_level;
 }
 
+auto PluginBase::get_levels(Levels& levels, uint& serial) const -> bool {
+  const auto current_serial = levels_serial.load(std::memory_order_acquire);
+
+  if (current_serial == serial) {
+    return false;
+  }
+
+  // The four values may come from two consecutive windows. That is invisible on a meter.
+
+  levels.input_left = input_peak_db_left.load(std::memory_order_relaxed);
+  levels.input_right = input_peak_db_right.load(std::memory_order_relaxed);
+  levels.output_left = output_peak_db_left.load(std::memory_order_relaxed);
+  levels.output_right = output_peak_db_right.load(std::memory_order_relaxed);
+
+  serial = current_serial;
+
+  return true;
+}
+
 void PluginBase::update_probe_links() {}
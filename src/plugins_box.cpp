@@ -41,8 +41,18 @@ struct Data {
 
   PipelineType pipeline_type;
 
+  uint input_axis_serial = 0U, output_axis_serial = 0U;
+
+  std::shared_ptr<PluginBase> spectra_plugin;  // the plugin whose taps we are subscribed to
+
+  SpectrumAnalyzer::Frame input_frame, output_frame;
+
+  bool updating_pages = false;
+
   std::map<std::string, std::string> translated;
 
+  std::map<std::string, GtkWidget*> pages;  // placeholder box of each plugin page. We hold a reference to them.
+
   std::vector<sigc::connection> connections;
 
   std::vector<gulong> gconnections;
@@ -61,6 +71,12 @@ struct _PluginsBox {
 
   GtkStack* stack;
 
+  GtkToggleButton* show_spectra;
+
+  GtkBox *input_spectrum_box, *output_spectrum_box;
+
+  ui::chart::Chart *input_chart, *output_chart;
+
   GtkBox *startpoint_box, *endpoint_box;
 
   GtkImage *startpoint_icon, *endpoint_icon;
@@ -76,8 +92,130 @@ struct _PluginsBox {
 
 G_DEFINE_TYPE(PluginsBox, plugins_box, GTK_TYPE_BOX)
 
+void release_spectra(PluginsBox* self) {
+  if (self->data->spectra_plugin == nullptr) {
+    return;
+  }
+
+  SpectrumAnalyzer::get().unsubscribe(self->data->spectra_plugin->input_tap);
+  SpectrumAnalyzer::get().unsubscribe(self->data->spectra_plugin->output_tap);
+
+  self->data->spectra_plugin = nullptr;
+}
+
+/*
+  Only the visible plugin is analyzed and only while the comparison is shown. Every other tap stays unsubscribed so
+  the realtime thread does not copy its samples.
+*/
+
+void update_spectra(PluginsBox* self) {
+  if (self->data->updating_pages) {
+    return;
+  }
+
+  release_spectra(self);
+
+  if (!self->data->schedule_signal_idle || gtk_toggle_button_get_active(self->show_spectra) == 0) {
+    return;
+  }
+
+  const auto* name = gtk_stack_get_visible_child_name(self->stack);
+
+  if (name == nullptr) {
+    return;
+  }
+
+  auto* effects_base = (self->data->pipeline_type == PipelineType::input)
+                           ? static_cast<EffectsBase*>(self->data->application->sie)
+                           : static_cast<EffectsBase*>(self->data->application->soe);
+
+  auto plugin = effects_base->get_plugin_instance<PluginBase>(name);
+
+  if (plugin == nullptr) {
+    return;
+  }
+
+  SpectrumAnalyzer::get().subscribe(plugin->input_tap);
+  SpectrumAnalyzer::get().subscribe(plugin->output_tap);
+
+  self->data->spectra_plugin = plugin;
+
+  // forcing the x axis to be set again with the first frames of the new taps
+
+  self->data->input_axis_serial = 0U;
+  self->data->output_axis_serial = 0U;
+}
+
+void update_spectrum_chart(ui::chart::Chart* chart,
+                           const std::shared_ptr<SpectrumAnalyzer::Tap>& tap,
+                           SpectrumAnalyzer::Frame& frame,
+                           uint& axis_serial) {
+  if (!tap->get_frame(frame)) {
+    return;
+  }
+
+  if (frame.axis_serial != axis_serial) {
+    axis_serial = frame.axis_serial;
+
+    ui::chart::set_x_data(chart, frame.frequencies);
+  }
+
+  ui::chart::set_y_data(chart, frame.magnitudes);
+}
+
+void setup_spectra(PluginsBox* self) {
+  auto* settings_spectrum = g_settings_new((tags::app::id + ".spectrum").c_str());
+
+  for (auto* chart : {self->input_chart, self->output_chart}) {
+    ui::chart::set_chart_type(chart, ui::chart::ChartType::line);
+    ui::chart::set_chart_scale(chart, ui::chart::ChartScale::logarithmic);
+
+    ui::chart::set_color(chart, util::gsettings_get_color(settings_spectrum, "color"));
+    ui::chart::set_axis_labels_color(chart, util::gsettings_get_color(settings_spectrum, "color-axis-labels"));
+    ui::chart::set_line_width(chart, g_settings_get_double(settings_spectrum, "line-width"));
+
+    ui::chart::set_x_unit(chart, "Hz");
+    ui::chart::set_y_unit(chart, "dB");
+
+    ui::chart::set_n_x_decimals(chart, 0);
+    ui::chart::set_n_y_decimals(chart, 1);
+
+    ui::chart::set_margin(chart, 0);
+
+    gtk_widget_set_size_request(GTK_WIDGET(chart), -1, g_settings_get_int(settings_spectrum, "height"));
+  }
+
+  g_object_unref(settings_spectrum);
+
+  gtk_box_append(self->input_spectrum_box, GTK_WIDGET(self->input_chart));
+  gtk_box_append(self->output_spectrum_box, GTK_WIDGET(self->output_chart));
+
+  g_signal_connect(self->show_spectra, "toggled",
+                   G_CALLBACK(+[](GtkToggleButton* btn, PluginsBox* self) { update_spectra(self); }), self);
+
+  g_signal_connect(self->stack, "notify::visible-child-name",
+                   G_CALLBACK(+[](GtkStack* stack, GParamSpec* pspec, PluginsBox* self) { update_spectra(self); }),
+                   self);
+
+  // The charts are only mapped while the comparison is shown
+
+  add_tick_callback(GTK_WIDGET(self->input_chart), [=]() {
+    if (self->data->spectra_plugin != nullptr) {
+      update_spectrum_chart(self->input_chart, self->data->spectra_plugin->input_tap, self->data->input_frame,
+                            self->data->input_axis_serial);
+    }
+  });
+
+  add_tick_callback(GTK_WIDGET(self->output_chart), [=]() {
+    if (self->data->spectra_plugin != nullptr) {
+      update_spectrum_chart(self->output_chart, self->data->spectra_plugin->output_tap, self->data->output_frame,
+                            self->data->output_axis_serial);
+    }
+  });
+}
+
 template <PipelineType pipeline_type>
-void add_plugins_to_stack(PluginsBox* self) {
+auto create_plugin_box(PluginsBox* self, const std::string& name) -> GtkWidget* {
   std::string schema_path;
   EffectsBase* effects_base;
 
@@ -93,239 +231,327 @@ void add_plugins_to_stack(PluginsBox* self) {
 
   std::replace(schema_path.begin(), schema_path.end(), '.', '/');
 
-  // saving the current visible page name for later usage
+  // With rfind we check if the plugin name starts with a given base name
 
-  std::string visible_page_name =
-      (gtk_stack_get_visible_child_name(self->stack) != nullptr) ? gtk_stack_get_visible_child_name(self->stack) : "";
+  if (name.rfind(plugin_name::autogain, 0) == 0) {
+    auto* box = ui::autogain_box::create();
 
-  // removing all plugins
+    auto plugin_ptr = effects_base->get_plugin_instance<AutoGain>(name);
 
-  for (auto child = gtk_widget_get_first_child(GTK_WIDGET(self->stack)); child != nullptr;) {
-    auto* next_child = gtk_widget_get_next_sibling(child);
+    ui::autogain_box::setup(box, plugin_ptr, schema_path + name + "/");
 
-    gtk_stack_remove(self->stack, child);
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::bass_enhancer, 0) == 0) {
+    auto* box = ui::bass_enhancer_box::create();
 
-    child = next_child;
-  }
+    auto plugin_ptr = effects_base->get_plugin_instance<BassEnhancer>(name);
 
-  // Adding to the stack the plugins in the list that are not there yet
+    auto path = name + "/";
 
-  auto plugins_list = util::gchar_array_to_vector(g_settings_get_strv(self->settings, "plugins"));
+    path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
+
+    ui::bass_enhancer_box::setup(box, plugin_ptr, schema_path + path);
+
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::bass_loudness, 0) == 0) {
+    auto* box = ui::bass_loudness_box::create();
+
+    auto plugin_ptr = effects_base->get_plugin_instance<BassLoudness>(name);
+
+    auto path = name + "/";
+
+    path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
+
+    ui::bass_loudness_box::setup(box, plugin_ptr, schema_path + path);
+
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::compressor, 0) == 0) {
+    auto* box = ui::compressor_box::create();
+
+    auto plugin_ptr = effects_base->get_plugin_instance<Compressor>(name);
+
+    ui::compressor_box::setup(box, plugin_ptr, schema_path + name + "/", self->data->application->pm);
+
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::convolver, 0) == 0) {
+    auto* box = ui::convolver_box::create();
+
+    auto plugin_ptr = effects_base->get_plugin_instance<Convolver>(name);
+
+    ui::convolver_box::setup(box, plugin_ptr, schema_path + name + "/", self->data->application);
+
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::crossfeed, 0) == 0) {
+    auto* box = ui::crossfeed_box::create();
 
-  for (const auto& name : plugins_list) {
-    // With rfind we check if the plugin name starts with a given base name
+    auto plugin_ptr = effects_base->get_plugin_instance<Crossfeed>(name);
 
-    if (name.rfind(plugin_name::autogain, 0) == 0) {
-      auto* box = ui::autogain_box::create();
+    ui::crossfeed_box::setup(box, plugin_ptr, schema_path + name + "/");
 
-      auto plugin_ptr = effects_base->get_plugin_instance<AutoGain>(name);
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::crystalizer, 0) == 0) {
+    auto* box = ui::crystalizer_box::create();
 
-      ui::autogain_box::setup(box, plugin_ptr, schema_path + name + "/");
+    auto plugin_ptr = effects_base->get_plugin_instance<Crystalizer>(name);
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::bass_enhancer, 0) == 0) {
-      auto* box = ui::bass_enhancer_box::create();
+    ui::crystalizer_box::setup(box, plugin_ptr, schema_path + name + "/");
 
-      auto plugin_ptr = effects_base->get_plugin_instance<BassEnhancer>(name);
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::deesser, 0) == 0) {
+    auto* box = ui::deesser_box::create();
 
-      auto path = name + "/";
+    auto plugin_ptr = effects_base->get_plugin_instance<Deesser>(name);
 
-      path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
+    ui::deesser_box::setup(box, plugin_ptr, schema_path + name + "/");
 
-      ui::bass_enhancer_box::setup(box, plugin_ptr, schema_path + path);
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::delay, 0) == 0) {
+    auto* box = ui::delay_box::create();
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::bass_loudness, 0) == 0) {
-      auto* box = ui::bass_loudness_box::create();
+    auto plugin_ptr = effects_base->get_plugin_instance<Delay>(name);
 
-      auto plugin_ptr = effects_base->get_plugin_instance<BassLoudness>(name);
+    ui::delay_box::setup(box, plugin_ptr, schema_path + name + "/");
 
-      auto path = name + "/";
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::echo_canceller, 0) == 0) {
+    auto* box = ui::echo_canceller_box::create();
 
-      path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
+    auto plugin_ptr = effects_base->get_plugin_instance<EchoCanceller>(name);
 
-      ui::bass_loudness_box::setup(box, plugin_ptr, schema_path + path);
+    auto path = name + "/";
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::compressor, 0) == 0) {
-      auto* box = ui::compressor_box::create();
+    path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Compressor>(name);
+    ui::echo_canceller_box::setup(box, plugin_ptr, schema_path + path);
 
-      ui::compressor_box::setup(box, plugin_ptr, schema_path + name + "/", self->data->application->pm);
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::exciter, 0) == 0) {
+    auto* box = ui::exciter_box::create();
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::convolver, 0) == 0) {
-      auto* box = ui::convolver_box::create();
+    auto plugin_ptr = effects_base->get_plugin_instance<Exciter>(name);
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Convolver>(name);
+    ui::exciter_box::setup(box, plugin_ptr, schema_path + name + "/");
 
-      ui::convolver_box::setup(box, plugin_ptr, schema_path + name + "/", self->data->application);
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::equalizer, 0) == 0) {
+    auto* box = ui::equalizer_box::create();
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::crossfeed, 0) == 0) {
-      auto* box = ui::crossfeed_box::create();
+    auto plugin_ptr = effects_base->get_plugin_instance<Equalizer>(name);
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Crossfeed>(name);
+    ui::equalizer_box::setup(box, plugin_ptr, schema_path + name + "/", self->data->application);
 
-      ui::crossfeed_box::setup(box, plugin_ptr, schema_path + name + "/");
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::filter, 0) == 0) {
+    auto* box = ui::filter_box::create();
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::crystalizer, 0) == 0) {
-      auto* box = ui::crystalizer_box::create();
+    auto plugin_ptr = effects_base->get_plugin_instance<Filter>(name);
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Crystalizer>(name);
+    ui::filter_box::setup(box, plugin_ptr, schema_path + name + "/");
 
-      ui::crystalizer_box::setup(box, plugin_ptr, schema_path + name + "/");
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::gate, 0) == 0) {
+    auto* box = ui::gate_box::create();
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::deesser, 0) == 0) {
-      auto* box = ui::deesser_box::create();
+    auto plugin_ptr = effects_base->get_plugin_instance<Gate>(name);
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Deesser>(name);
+    ui::gate_box::setup(box, plugin_ptr, schema_path + name + "/");
 
-      ui::deesser_box::setup(box, plugin_ptr, schema_path + name + "/");
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::limiter, 0) == 0) {
+    auto* box = ui::limiter_box::create();
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::delay, 0) == 0) {
-      auto* box = ui::delay_box::create();
+    auto plugin_ptr = effects_base->get_plugin_instance<Limiter>(name);
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Delay>(name);
+    ui::limiter_box::setup(box, plugin_ptr, schema_path + name + "/", self->data->application->pm);
 
-      ui::delay_box::setup(box, plugin_ptr, schema_path + name + "/");
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::loudness, 0) == 0) {
+    auto* box = ui::loudness_box::create();
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::echo_canceller, 0) == 0) {
-      auto* box = ui::echo_canceller_box::create();
+    auto plugin_ptr = effects_base->get_plugin_instance<Loudness>(name);
 
-      auto plugin_ptr = effects_base->get_plugin_instance<EchoCanceller>(name);
+    ui::loudness_box::setup(box, plugin_ptr, schema_path + name + "/");
 
-      auto path = name + "/";
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::maximizer, 0) == 0) {
+    auto* box = ui::maximizer_box::create();
 
-      path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
+    auto plugin_ptr = effects_base->get_plugin_instance<Maximizer>(name);
 
-      ui::echo_canceller_box::setup(box, plugin_ptr, schema_path + path);
+    ui::maximizer_box::setup(box, plugin_ptr, schema_path + name + "/");
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::exciter, 0) == 0) {
-      auto* box = ui::exciter_box::create();
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::multiband_compressor, 0) == 0) {
+    auto* box = ui::multiband_compressor_box::create();
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Exciter>(name);
+    auto plugin_ptr = effects_base->get_plugin_instance<MultibandCompressor>(name);
 
-      ui::exciter_box::setup(box, plugin_ptr, schema_path + name + "/");
+    auto path = name + "/";
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::equalizer, 0) == 0) {
-      auto* box = ui::equalizer_box::create();
+    path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Equalizer>(name);
+    ui::multiband_compressor_box::setup(box, plugin_ptr, schema_path + path, self->data->application->pm);
 
-      ui::equalizer_box::setup(box, plugin_ptr, schema_path + name + "/", self->data->application);
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::multiband_gate, 0) == 0) {
+    auto* box = ui::multiband_gate_box::create();
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::filter, 0) == 0) {
-      auto* box = ui::filter_box::create();
+    auto plugin_ptr = effects_base->get_plugin_instance<MultibandGate>(name);
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Filter>(name);
+    auto path = name + "/";
 
-      ui::filter_box::setup(box, plugin_ptr, schema_path + name + "/");
+    path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::gate, 0) == 0) {
-      auto* box = ui::gate_box::create();
+    ui::multiband_gate_box::setup(box, plugin_ptr, schema_path + path);
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Gate>(name);
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::pitch, 0) == 0) {
+    auto* box = ui::pitch_box::create();
 
-      ui::gate_box::setup(box, plugin_ptr, schema_path + name + "/");
+    auto plugin_ptr = effects_base->get_plugin_instance<Pitch>(name);
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::limiter, 0) == 0) {
-      auto* box = ui::limiter_box::create();
+    ui::pitch_box::setup(box, plugin_ptr, schema_path + name + "/");
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Limiter>(name);
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::reverb, 0) == 0) {
+    auto* box = ui::reverb_box::create();
 
-      ui::limiter_box::setup(box, plugin_ptr, schema_path + name + "/", self->data->application->pm);
+    auto plugin_ptr = effects_base->get_plugin_instance<Reverb>(name);
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::loudness, 0) == 0) {
-      auto* box = ui::loudness_box::create();
+    ui::reverb_box::setup(box, plugin_ptr, schema_path + name + "/");
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Loudness>(name);
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::rnnoise, 0) == 0) {
+    auto* box = ui::rnnoise_box::create();
 
-      ui::loudness_box::setup(box, plugin_ptr, schema_path + name + "/");
+    auto plugin_ptr = effects_base->get_plugin_instance<RNNoise>(name);
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::maximizer, 0) == 0) {
-      auto* box = ui::maximizer_box::create();
+    ui::rnnoise_box::setup(box, plugin_ptr, schema_path + name + "/", self->data->application);
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Maximizer>(name);
+    return GTK_WIDGET(box);
+  } else if (name.rfind(plugin_name::stereo_tools, 0) == 0) {
+    auto* box = ui::stereo_tools_box::create();
 
-      ui::maximizer_box::setup(box, plugin_ptr, schema_path + name + "/");
+    auto plugin_ptr = effects_base->get_plugin_instance<StereoTools>(name);
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::multiband_compressor, 0) == 0) {
-      auto* box = ui::multiband_compressor_box::create();
+    auto path = name + "/";
 
-      auto plugin_ptr = effects_base->get_plugin_instance<MultibandCompressor>(name);
+    path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
+
+    ui::stereo_tools_box::setup(box, plugin_ptr, schema_path + path);
+
+    return GTK_WIDGET(box);
+  }
+
+  return nullptr;
+}
+
+/*
+  The stack holds a light placeholder box for each plugin. The real plugin box with all its settings bindings is
+  only built inside the placeholder the first time the page is shown.
+*/
+
+void build_visible_page(PluginsBox* self) {
+  if (self->data->updating_pages) {
+    return;
+  }
+
+  const auto* name = gtk_stack_get_visible_child_name(self->stack);
+
+  if (name == nullptr) {
+    return;
+  }
+
+  auto* placeholder = gtk_stack_get_visible_child(self->stack);
+
+  if (gtk_widget_get_first_child(placeholder) != nullptr) {
+    return;
+  }
 
-      auto path = name + "/";
+  GtkWidget* box = nullptr;
 
-      path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
+  switch (self->data->pipeline_type) {
+    case PipelineType::input:
+      box = create_plugin_box<PipelineType::input>(self, name);
+      break;
+    case PipelineType::output:
+      box = create_plugin_box<PipelineType::output>(self, name);
+      break;
+  }
 
-      ui::multiband_compressor_box::setup(box, plugin_ptr, schema_path + path, self->data->application->pm);
+  if (box != nullptr) {
+    gtk_box_append(GTK_BOX(placeholder), box);
+  }
+}
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::multiband_gate, 0) == 0) {
-      auto* box = ui::multiband_gate_box::create();
+/*
+  The pages are diffed against the new list. Only the pages of added plugins are created and only the pages of
+  removed plugins are destroyed. As GtkStack has no way to move a page, reordered pages are taken out of the stack
+  and added back in the new order. The reference we keep in self->data->pages keeps them alive in between.
+*/
 
-      auto plugin_ptr = effects_base->get_plugin_instance<MultibandGate>(name);
+void update_stack_pages(PluginsBox* self) {
+  auto plugins_list = util::gchar_array_to_vector(g_settings_get_strv(self->settings, "plugins"));
 
-      auto path = name + "/";
+  // saving the current visible page name for later usage
 
-      path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
+  std::string visible_page_name =
+      (gtk_stack_get_visible_child_name(self->stack) != nullptr) ? gtk_stack_get_visible_child_name(self->stack) : "";
 
-      ui::multiband_gate_box::setup(box, plugin_ptr, schema_path + path);
+  // The stack changes its visible child while pages are moved. Nothing should be built until we are done.
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::pitch, 0) == 0) {
-      auto* box = ui::pitch_box::create();
+  self->data->updating_pages = true;
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Pitch>(name);
+  // removing the plugins that are not in the list anymore
 
-      ui::pitch_box::setup(box, plugin_ptr, schema_path + name + "/");
+  for (auto it = self->data->pages.begin(); it != self->data->pages.end();) {
+    if (std::ranges::find(plugins_list, it->first) == plugins_list.end()) {
+      gtk_stack_remove(self->stack, it->second);
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::reverb, 0) == 0) {
-      auto* box = ui::reverb_box::create();
+      g_object_unref(it->second);
 
-      auto plugin_ptr = effects_base->get_plugin_instance<Reverb>(name);
+      it = self->data->pages.erase(it);
+    } else {
+      ++it;
+    }
+  }
 
-      ui::reverb_box::setup(box, plugin_ptr, schema_path + name + "/");
+  // the order of the pages that are left
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::rnnoise, 0) == 0) {
-      auto* box = ui::rnnoise_box::create();
+  std::vector<std::string> current_order;
 
-      auto plugin_ptr = effects_base->get_plugin_instance<RNNoise>(name);
+  for (auto* child = gtk_widget_get_first_child(GTK_WIDGET(self->stack)); child != nullptr;
+       child = gtk_widget_get_next_sibling(child)) {
+    current_order.emplace_back(gtk_stack_page_get_name(gtk_stack_get_page(self->stack, child)));
+  }
 
-      ui::rnnoise_box::setup(box, plugin_ptr, schema_path + name + "/", self->data->application);
+  // Pages from the first position where the old order differs from the new one have to be added again
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
-    } else if (name.rfind(plugin_name::stereo_tools, 0) == 0) {
-      auto* box = ui::stereo_tools_box::create();
+  size_t first_moved = 0U;
 
-      auto plugin_ptr = effects_base->get_plugin_instance<StereoTools>(name);
+  while (first_moved < current_order.size() && first_moved < plugins_list.size() &&
+         current_order[first_moved] == plugins_list[first_moved]) {
+    first_moved++;
+  }
 
-      auto path = name + "/";
+  for (size_t n = first_moved; n < current_order.size(); n++) {
+    gtk_stack_remove(self->stack, self->data->pages[current_order[n]]);
+  }
 
-      path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
+  for (size_t n = first_moved; n < plugins_list.size(); n++) {
+    const auto& name = plugins_list[n];
 
-      ui::stereo_tools_box::setup(box, plugin_ptr, schema_path + path);
+    if (!self->data->pages.contains(name)) {
+      auto* placeholder = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
 
-      gtk_stack_add_named(self->stack, GTK_WIDGET(box), name.c_str());
+      self->data->pages[name] = GTK_WIDGET(g_object_ref_sink(placeholder));
     }
+
+    gtk_stack_add_named(self->stack, self->data->pages[name], name.c_str());
   }
 
+  self->data->updating_pages = false;
+
   if (plugins_list.empty()) {
     gtk_widget_show(GTK_WIDGET(self->overlay_no_plugins));
 
@@ -343,6 +569,12 @@ void add_plugins_to_stack(PluginsBox* self) {
       gtk_stack_set_visible_child_name(self->stack, visible_page_name.c_str());
     }
   }
+
+  build_visible_page(self);
+
+  // the plugin we were analyzing may have been removed
+
+  update_spectra(self);
 }
 
 void setup_listview(PluginsBox* self) {
@@ -518,11 +750,11 @@ void setup(PluginsBox* self, app::Application* application, PipelineType pipelin
     case PipelineType::input: {
       self->settings = g_settings_new((tags::app::id + ".streaminputs").c_str());
 
-      add_plugins_to_stack<PipelineType::input>(self);
+      update_stack_pages(self);
 
       self->data->gconnections.push_back(g_signal_connect(
           self->settings, "changed::plugins", G_CALLBACK(+[](GSettings* settings, char* key, PluginsBox* self) {
-            add_plugins_to_stack<PipelineType::input>(self);
+            update_stack_pages(self);
           }),
           self));
 
@@ -537,11 +769,11 @@ void setup(PluginsBox* self, app::Application* application, PipelineType pipelin
     case PipelineType::output: {
       self->settings = g_settings_new((tags::app::id + ".streamoutputs").c_str());
 
-      add_plugins_to_stack<PipelineType::output>(self);
+      update_stack_pages(self);
 
       self->data->gconnections.push_back(g_signal_connect(
           self->settings, "changed::plugins", G_CALLBACK(+[](GSettings* settings, char* key, PluginsBox* self) {
-            add_plugins_to_stack<PipelineType::output>(self);
+            update_stack_pages(self);
           }),
           self));
 
@@ -558,6 +790,12 @@ void setup(PluginsBox* self, app::Application* application, PipelineType pipelin
   ui::plugins_menu::setup(self->plugins_menu, application, pipeline_type);
 
   setup_listview(self);
+
+  setup_spectra(self);
+
+  g_signal_connect(self->stack, "notify::visible-child-name",
+                   G_CALLBACK(+[](GtkStack* stack, GParamSpec* pspec, PluginsBox* self) { build_visible_page(self); }),
+                   self);
 }
 
 void realize(GtkWidget* widget) {
@@ -565,6 +803,8 @@ void realize(GtkWidget* widget) {
 
   self->data->schedule_signal_idle = true;
 
+  update_spectra(self);
+
   GTK_WIDGET_CLASS(plugins_box_parent_class)->realize(widget);
 }
 
@@ -573,12 +813,16 @@ void unroot(GtkWidget* widget) {
 
   self->data->schedule_signal_idle = false;
 
+  release_spectra(self);
+
   GTK_WIDGET_CLASS(plugins_box_parent_class)->unroot(widget);
 }
 
 void dispose(GObject* object) {
   auto* self = EE_PLUGINS_BOX(object);
 
+  release_spectra(self);
+
   for (auto& c : self->data->connections) {
     c.disconnect();
   }
@@ -590,6 +834,12 @@ void dispose(GObject* object) {
   self->data->connections.clear();
   self->data->gconnections.clear();
 
+  for (auto& [name, page] : self->data->pages) {
+    g_object_unref(page);
+  }
+
+  self->data->pages.clear();
+
   g_object_unref(self->settings);
 
   util::debug(log_tag + "disposed"s);
@@ -624,6 +874,9 @@ void plugins_box_class_init(PluginsBoxClass* klass) {
   gtk_widget_class_bind_template_child(widget_class, PluginsBox, overlay_no_plugins);
   gtk_widget_class_bind_template_child(widget_class, PluginsBox, listview);
   gtk_widget_class_bind_template_child(widget_class, PluginsBox, stack);
+  gtk_widget_class_bind_template_child(widget_class, PluginsBox, show_spectra);
+  gtk_widget_class_bind_template_child(widget_class, PluginsBox, input_spectrum_box);
+  gtk_widget_class_bind_template_child(widget_class, PluginsBox, output_spectrum_box);
   gtk_widget_class_bind_template_child(widget_class, PluginsBox, startpoint_box);
   gtk_widget_class_bind_template_child(widget_class, PluginsBox, startpoint_icon);
   gtk_widget_class_bind_template_child(widget_class, PluginsBox, startpoint_name);
@@ -641,6 +894,9 @@ void plugins_box_init(PluginsBox* self) {
 
   self->plugins_menu = ui::plugins_menu::create();
 
+  self->input_chart = ui::chart::create();
+  self->output_chart = ui::chart::create();
+
   gtk_menu_button_set_popover(self->menubutton_plugins, GTK_WIDGET(self->plugins_menu));
 
   gtk_overlay_set_clip_overlay(self->plugin_overlay, GTK_WIDGET(self->overlay_no_plugins), 1);
@@ -29,9 +29,10 @@ struct _PreferencesGeneral {
   AdwPreferencesPage parent_instance;
 
   GtkSwitch *enable_autostart, *process_all_inputs, *process_all_outputs, *theme_switch, *shutdown_on_window_close,
-      *use_cubic_volumes, *autohide_popovers, *reset_volume_on_startup, *exclude_monitor_streams;
+      *use_cubic_volumes, *autohide_popovers, *reset_volume_on_startup, *exclude_monitor_streams,
+      *process_channels_in_parallel;
 
-  GtkSpinButton* inactivity_timeout;
+  GtkSpinButton *inactivity_timeout, *convolver_threads, *convolver_thread_priority;
 
   GSettings* settings;
 };
@@ -102,7 +103,10 @@ void preferences_general_class_init(PreferencesGeneralClass* klass) {
   gtk_widget_class_bind_template_child(widget_class, PreferencesGeneral, use_cubic_volumes);
   gtk_widget_class_bind_template_child(widget_class, PreferencesGeneral, reset_volume_on_startup);
   gtk_widget_class_bind_template_child(widget_class, PreferencesGeneral, exclude_monitor_streams);
+  gtk_widget_class_bind_template_child(widget_class, PreferencesGeneral, process_channels_in_parallel);
   gtk_widget_class_bind_template_child(widget_class, PreferencesGeneral, inactivity_timeout);
+  gtk_widget_class_bind_template_child(widget_class, PreferencesGeneral, convolver_threads);
+  gtk_widget_class_bind_template_child(widget_class, PreferencesGeneral, convolver_thread_priority);
 
   gtk_widget_class_bind_template_callback(widget_class, on_enable_autostart);
 }
@@ -122,10 +126,12 @@ void preferences_general_init(PreferencesGeneral* self) {
 
   gsettings_bind_widgets<"process-all-inputs", "process-all-outputs", "use-dark-theme", "shutdown-on-window-close",
                          "use-cubic-volumes", "autohide-popovers", "reset-volume-on-startup", "exclude-monitor-streams",
-                         "inactivity-timeout">(
+                         "inactivity-timeout", "convolver-threads", "convolver-thread-priority",
+                         "process-channels-in-parallel">(
       self->settings, self->process_all_inputs, self->process_all_outputs, self->theme_switch,
       self->shutdown_on_window_close, self->use_cubic_volumes, self->autohide_popovers, self->reset_volume_on_startup,
-      self->exclude_monitor_streams, self->inactivity_timeout);
+      self->exclude_monitor_streams, self->inactivity_timeout, self->convolver_threads, self->convolver_thread_priority,
+      self->process_channels_in_parallel);
 }
 
 auto create() -> PreferencesGeneral* {
@@ -35,13 +35,13 @@ struct Data {
 struct _PreferencesSpectrum {
   AdwPreferencesPage parent_instance;
 
-  GtkSwitch *show, *fill, *show_bar_border, *rounded_corners;
+  GtkSwitch *show, *fill, *show_bar_border, *rounded_corners, *peak_hold, *multi_resolution;
 
   GtkColorButton *color_button, *axis_color_button;
 
   GtkComboBoxText* type;
 
-  GtkSpinButton *n_points, *height, *line_width, *minimum_frequency, *maximum_frequency;
+  GtkSpinButton *n_points, *height, *line_width, *minimum_frequency, *maximum_frequency, *peak_decay;
 
   GSettings* settings;
 
@@ -109,10 +109,13 @@ void preferences_spectrum_class_init(PreferencesSpectrumClass* klass) {
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, height);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, show_bar_border);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, rounded_corners);
+  gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, peak_hold);
+  gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, peak_decay);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, color_button);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, axis_color_button);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, minimum_frequency);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, maximum_frequency);
+  gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, multi_resolution);
 
   gtk_widget_class_bind_template_callback(widget_class, on_spectrum_color_set);
   gtk_widget_class_bind_template_callback(widget_class, on_spectrum_axis_color_set);
@@ -139,6 +142,8 @@ void preferences_spectrum_init(PreferencesSpectrum* self) {
 
   prepare_spinbuttons<"px">(self->height, self->line_width);
 
+  prepare_spinbuttons<"dB/s">(self->peak_decay);
+
   g_signal_connect(self->minimum_frequency, "output", G_CALLBACK(+[](GtkSpinButton* button, gpointer user_data) {
                      return parse_spinbutton_output(button, "Hz");
                    }),
@@ -189,6 +194,8 @@ void preferences_spectrum_init(PreferencesSpectrum* self) {
   g_settings_bind(self->settings, "fill", self->fill, "active", G_SETTINGS_BIND_DEFAULT);
   g_settings_bind(self->settings, "rounded-corners", self->rounded_corners, "active", G_SETTINGS_BIND_DEFAULT);
   g_settings_bind(self->settings, "show-bar-border", self->show_bar_border, "active", G_SETTINGS_BIND_DEFAULT);
+  g_settings_bind(self->settings, "peak-hold", self->peak_hold, "active", G_SETTINGS_BIND_DEFAULT);
+  g_settings_bind(self->settings, "multi-resolution", self->multi_resolution, "active", G_SETTINGS_BIND_DEFAULT);
 
   g_settings_bind(self->settings, "n-points", gtk_spin_button_get_adjustment(self->n_points), "value",
                   G_SETTINGS_BIND_DEFAULT);
@@ -200,6 +207,8 @@ void preferences_spectrum_init(PreferencesSpectrum* self) {
                   G_SETTINGS_BIND_DEFAULT);
   g_settings_bind(self->settings, "maximum-frequency", gtk_spin_button_get_adjustment(self->maximum_frequency), "value",
                   G_SETTINGS_BIND_DEFAULT);
+  g_settings_bind(self->settings, "peak-decay", gtk_spin_button_get_adjustment(self->peak_decay), "value",
+                  G_SETTINGS_BIND_DEFAULT);
 
   g_settings_bind(self->settings, "type", self->type, "active-id", G_SETTINGS_BIND_DEFAULT);
 
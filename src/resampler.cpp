@@ -19,10 +19,41 @@
 
 #include "resampler.hpp"
 
-Resampler::Resampler(const int& input_rate, const int& output_rate) : output(1, 0) {
-  resample_ratio = static_cast<float>(output_rate) / static_cast<float>(input_rate);
+Resampler::Resampler(const int& input_rate, const int& output_rate, const Quality& quality) {
+  resample_ratio = static_cast<double>(output_rate) / static_cast<double>(input_rate);
 
-  src_state = src_new(SRC_SINC_FASTEST, 1, nullptr);
+  const auto divisor = std::gcd(input_rate, output_rate);
+
+  if (divisor > 0) {
+    upsampling_factor = static_cast<uint>(output_rate / divisor);
+    downsampling_factor = static_cast<uint>(input_rate / divisor);
+  }
+
+  const bool small_factors = divisor > 0 && upsampling_factor <= max_polyphase_factor &&
+                             downsampling_factor <= max_polyphase_factor;
+
+  switch (quality) {
+    case Quality::fastest:
+      if (small_factors) {
+        setup_polyphase(32U);
+      } else {
+        src_state = src_new(SRC_SINC_FASTEST, 1, nullptr);
+      }
+
+      break;
+    case Quality::medium:
+      if (small_factors) {
+        setup_polyphase(64U);
+      } else {
+        src_state = src_new(SRC_SINC_MEDIUM_QUALITY, 1, nullptr);
+      }
+
+      break;
+    case Quality::best:
+      src_state = src_new(SRC_SINC_BEST_QUALITY, 1, nullptr);
+
+      break;
+  }
 }
 
 Resampler::~Resampler() {
@@ -30,3 +61,191 @@ Resampler::~Resampler() {
     src_delete(src_state);
   }
 }
+
+auto Resampler::is_polyphase() const -> bool {
+  return n_taps != 0U;
+}
+
+auto Resampler::get_max_output_frames(const size_t& input_frames) const -> size_t {
+  if (is_polyphase()) {
+    // when the input ends n_taps / 2 zeros are added to flush the filter
+
+    const auto frames = static_cast<uint64_t>(input_frames + n_taps / 2U) * upsampling_factor;
+
+    return static_cast<size_t>(frames / downsampling_factor) + 1U;
+  }
+
+  return static_cast<size_t>(std::ceil(1.5 * resample_ratio * static_cast<double>(input_frames))) + 1U;
+}
+
+auto Resampler::process(std::span<const float> input, std::span<float> output, const bool& end_of_input) -> size_t {
+  if (is_polyphase()) {
+    return process_polyphase(input, output, end_of_input);
+  }
+
+  if (src_state == nullptr) {
+    return 0U;
+  }
+
+  // The number of frames of data pointed to by data_in
+  src_data.input_frames = static_cast<long>(input.size());
+
+  // A pointer to the input data samples
+  src_data.data_in = input.data();
+
+  // Maximum number of frames pointed to by data_out
+  src_data.output_frames = static_cast<long>(output.size());
+
+  // A pointer to the output data samples
+  src_data.data_out = output.data();
+
+  // Equal to output_sample_rate / input_sample_rate
+  src_data.src_ratio = resample_ratio;
+
+  // Equal to 0 if more input data is available and 1 otherwise
+  src_data.end_of_input = static_cast<int>(end_of_input);
+
+  src_process(src_state, &src_data);
+
+  return static_cast<size_t>(src_data.output_frames_gen);
+}
+
+void Resampler::setup_polyphase(const uint& taps) {
+  /*
+    When decimating the filter has to be longer by the decimation ratio to keep the same transition band relative to
+    the output rate. The length is kept a multiple of 8 for the dot product.
+  */
+
+  n_taps = (taps * downsampling_factor + upsampling_factor - 1U) / upsampling_factor;
+
+  n_taps = std::max(taps, (n_taps + 7U) & ~7U);
+
+  coefficients.resize(static_cast<size_t>(upsampling_factor) * n_taps);
+
+  history.resize(n_taps - 1U + chunk_size);
+
+  std::ranges::fill(history, 0.0F);
+
+  /*
+    Kaiser windowed sinc with beta = 8 (about 80 dB of stopband attenuation). Its transition band is close to 5 / n_taps
+    of the input rate. The cutoff is placed so that the stopband starts at the Nyquist frequency of the lowest of the
+    two rates.
+  */
+
+  constexpr double beta = 8.0;
+
+  const double half_length = 0.5 * static_cast<double>(n_taps);
+
+  const double cutoff =
+      0.5 * std::min(1.0, static_cast<double>(upsampling_factor) / static_cast<double>(downsampling_factor)) -
+      2.5 / static_cast<double>(n_taps);
+
+  const double window_norm = 1.0 / bessel_i0(beta);
+
+  for (uint p = 0U; p < upsampling_factor; p++) {
+    const double fraction = static_cast<double>(p) / static_cast<double>(upsampling_factor);
+
+    std::span phase{coefficients.begin() + static_cast<size_t>(p) * n_taps, n_taps};
+
+    double sum = 0.0;
+
+    for (uint i = 0U; i < n_taps; i++) {
+      // distance in input samples between the output and the input sample multiplied by this coefficient
+
+      const double t = static_cast<double>(n_taps - 1U - i) + fraction - half_length;
+
+      const double x = 2.0 * cutoff * t;
+
+      const double sinc = (t == 0.0) ? 1.0 : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+
+      const double u = t / half_length;
+
+      const double window = bessel_i0(beta * std::sqrt(std::max(0.0, 1.0 - u * u))) * window_norm;
+
+      const double h = 2.0 * cutoff * sinc * window;
+
+      phase[i] = static_cast<float>(h);
+
+      sum += h;
+    }
+
+    // every phase gets unit gain at zero frequency
+
+    for (auto& v : phase) {
+      v = static_cast<float>(static_cast<double>(v) / sum);
+    }
+  }
+}
+
+auto Resampler::process_polyphase(std::span<const float> input, std::span<float> output, const bool& end_of_input)
+    -> size_t {
+  size_t n_output = 0U;
+
+  for (size_t offset = 0U; offset < input.size(); offset += chunk_size) {
+    const auto count = std::min(static_cast<size_t>(chunk_size), input.size() - offset);
+
+    n_output += process_polyphase_chunk(input.subspan(offset, count), output.subspan(n_output));
+  }
+
+  if (end_of_input) {
+    // flushing the samples that are still inside the filter
+
+    static constexpr std::array<float, 64U> zeros{};
+
+    for (uint remaining = n_taps / 2U; remaining > 0U;) {
+      const auto count = std::min(remaining, static_cast<uint>(zeros.size()));
+
+      n_output += process_polyphase_chunk(std::span{zeros.data(), count}, output.subspan(n_output));
+
+      remaining -= count;
+    }
+  }
+
+  return n_output;
+}
+
+auto Resampler::process_polyphase_chunk(std::span<const float> input, std::span<float> output) -> size_t {
+  const uint history_size = n_taps - 1U;
+
+  std::copy(input.begin(), input.end(), history.begin() + history_size);
+
+  const auto chunk_end = static_cast<uint64_t>(input.size()) * upsampling_factor;
+
+  size_t n_output = 0U;
+
+  for (; position < chunk_end; position += downsampling_factor) {
+    const auto n = static_cast<size_t>(position / upsampling_factor);
+    const auto phase = static_cast<size_t>(position % upsampling_factor);
+
+    if (n_output < output.size()) {
+      output[n_output] = dot_product(coefficients.data() + phase * n_taps, history.data() + n, n_taps);
+
+      n_output++;
+    }
+  }
+
+  position -= chunk_end;
+
+  std::copy_n(history.begin() + input.size(), history_size, history.begin());
+
+  return n_output;
+}
+
+auto Resampler::bessel_i0(const double& x) -> double {
+  // power series of the modified Bessel function of the first kind and order 0
+
+  double sum = 1.0;
+  double term = 1.0;
+
+  for (uint k = 1U; k < 50U; k++) {
+    term *= (0.5 * x / static_cast<double>(k)) * (0.5 * x / static_cast<double>(k));
+
+    sum += term;
+
+    if (term < 1e-12 * sum) {
+      break;
+    }
+  }
+
+  return sum;
+}
@@ -23,43 +23,38 @@ RNNoise::RNNoise(const std::string& tag,
                  const std::string& schema,
                  const std::string& schema_path,
                  PipeManager* pipe_manager)
-    : PluginBase(tag, plugin_name::rnnoise, schema, schema_path, pipe_manager), data_L(0), data_R(0) {
+    : PluginBase(tag, plugin_name::rnnoise, schema, schema_path, pipe_manager),
+      data_L(0),
+      data_R(0),
+      data_mid(blocksize),
+      denoised_mid(blocksize),
+      stereo_link(std::make_unique<RNNoiseStereoLink>()) {
   data_L.reserve(blocksize);
   data_R.reserve(blocksize);
 
-  gconnections.push_back(g_signal_connect(settings, "changed::model-path",
+  gconnections.push_back(g_signal_connect(settings, "changed::channel-mode",
                                           G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
                                             auto self = static_cast<RNNoise*>(user_data);
 
-                                            self->data_mutex.lock();
-
-                                            self->rnnoise_ready = false;
-
-                                            self->data_mutex.unlock();
-
-                                            self->free_rnnoise();
+                                            std::scoped_lock<std::mutex> lock(self->data_mutex);
 
-                                            auto* m = self->get_model_from_file();
-
-                                            self->model = m;
+                                            self->set_channel_mode();
+                                          }),
+                                          this));
 
-                                            self->state_left = rnnoise_create(self->model);
-                                            self->state_right = rnnoise_create(self->model);
+  gconnections.push_back(g_signal_connect(settings, "changed::model-path",
+                                          G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                                            auto self = static_cast<RNNoise*>(user_data);
 
-                                            self->rnnoise_ready = true;
+                                            self->load_model();
                                           }),
                                           this));
 
   setup_input_output_gain();
 
-  auto* m = get_model_from_file();
+  set_channel_mode();
 
-  model = m;
-
-  state_left = rnnoise_create(model);
-  state_right = rnnoise_create(model);
-
-  rnnoise_ready = true;
+  load_model();
 }
 
 RNNoise::~RNNoise() {
@@ -88,18 +83,68 @@ void RNNoise::setup() {
   data_L.resize(0);
   data_R.resize(0);
 
-  deque_out_L.resize(0);
-  deque_out_R.resize(0);
-
   resampler_inL = std::make_unique<Resampler>(rate, rnnoise_rate);
   resampler_inR = std::make_unique<Resampler>(rate, rnnoise_rate);
 
   resampler_outL = std::make_unique<Resampler>(rnnoise_rate, rate);
   resampler_outR = std::make_unique<Resampler>(rnnoise_rate, rate);
 
+  const auto max_resampled_in = resampler_inL->get_max_output_frames(n_samples);
+
+  // rnnoise returns whole blocks, so it can give back up to blocksize more samples than it received
+
+  const auto max_denoised = max_resampled_in + blocksize;
+
+  resampled_in_L.resize(max_resampled_in);
+  resampled_in_R.resize(max_resampled_in);
+
+  resampled_data_L.reserve(max_denoised);
+  resampled_data_R.reserve(max_denoised);
+
+  resampled_out_L.resize(resampler_outL->get_max_output_frames(max_denoised));
+  resampled_out_R.resize(resampler_outR->get_max_output_frames(max_denoised));
+
+  mono_in.resize(n_samples);
+
+  // Room for one buffer waiting to be read plus what a single process call can add
+
+  const auto ring_size = n_samples + std::max(static_cast<size_t>(n_samples + blocksize), resampled_out_L.size());
+
+  ring_out_L.resize(ring_size);
+  ring_out_R.resize(ring_size);
+
+  stereo_link->reset();
+
   resampler_ready = true;
 }
 
+void RNNoise::set_channel_mode() {
+  switch (g_settings_get_enum(settings, "channel-mode")) {
+    case 1:
+      channel_mode = ChannelMode::linked;
+      break;
+    case 2:
+      channel_mode = ChannelMode::mono;
+      break;
+    default:
+      channel_mode = ChannelMode::stereo;
+      break;
+  }
+
+  // the channels have to start the next frame together
+
+  data_L.resize(0);
+  data_R.resize(0);
+
+  stereo_link->reset();
+
+  n_frames_saved = 0U;
+
+  // the linked mode has one more frame of latency
+
+  notify_latency = true;
+}
+
 void RNNoise::process(std::span<float>& left_in,
                       std::span<float>& right_in,
                       std::span<float>& left_out,
@@ -118,79 +163,81 @@ void RNNoise::process(std::span<float>& left_in,
   }
 
   if (resample) {
-    if (resampler_ready) {
-      const auto resampled_inL = resampler_inL->process(left_in, false);
-      const auto resampled_inR = resampler_inR->process(right_in, false);
+    if (resampler_ready && left_in.size() <= n_samples && channel_mode == ChannelMode::mono) {
+      // Both channels get the same signal. So a single pair of resamplers is enough.
+
+      for (size_t n = 0U; n < left_in.size(); n++) {
+        mono_in[n] = 0.5F * (left_in[n] + right_in[n]);
+      }
+
+      const auto n_in = resampler_inL->process(std::span{mono_in.data(), left_in.size()}, resampled_in_L, false);
 
       resampled_data_L.resize(0);
       resampled_data_R.resize(0);
 
-      remove_noise(resampled_inL, resampled_inR, resampled_data_L, resampled_data_R);
-
-      auto resampled_outL = resampler_outL->process(resampled_data_L, false);
-      auto resampled_outR = resampler_outR->process(resampled_data_R, false);
+      const std::span resampled_mono{resampled_in_L.data(), n_in};
 
-      for (const auto& v : resampled_outL) {
-        deque_out_L.push_back(v);
-      }
+      remove_noise(resampled_mono, resampled_mono, resampled_data_L, resampled_data_R);
 
-      for (const auto& v : resampled_outR) {
-        deque_out_R.push_back(v);
-      }
-    } else {
-      for (const auto& v : left_in) {
-        deque_out_L.push_back(v);
-      }
+      const auto n_out = resampler_outL->process(resampled_data_L, resampled_out_L, false);
 
-      for (const auto& v : right_in) {
-        deque_out_R.push_back(v);
-      }
-    }
-  } else {
-    remove_noise(left_in, right_in, deque_out_L, deque_out_R);
-  }
+      ring_out_L.push(std::span{resampled_out_L.data(), n_out});
+      ring_out_R.push(std::span{resampled_out_L.data(), n_out});
+    } else if (resampler_ready && left_in.size() <= n_samples) {
+      const auto n_in_L = resampler_inL->process(left_in, resampled_in_L, false);
+      const auto n_in_R = resampler_inR->process(right_in, resampled_in_R, false);
 
-  if (deque_out_L.size() >= left_out.size()) {
-    for (float& v : left_out) {
-      v = deque_out_L.front();
+      resampled_data_L.resize(0);
+      resampled_data_R.resize(0);
 
-      deque_out_L.pop_front();
-    }
+      remove_noise(std::span{resampled_in_L.data(), n_in_L}, std::span{resampled_in_R.data(), n_in_R},
+                   resampled_data_L, resampled_data_R);
 
-    for (float& v : right_out) {
-      v = deque_out_R.front();
+      const auto n_out_L = resampler_outL->process(resampled_data_L, resampled_out_L, false);
+      const auto n_out_R = resampler_outR->process(resampled_data_R, resampled_out_R, false);
 
-      deque_out_R.pop_front();
+      ring_out_L.push(std::span{resampled_out_L.data(), n_out_L});
+      ring_out_R.push(std::span{resampled_out_R.data(), n_out_R});
+    } else {
+      ring_out_L.push(left_in);
+      ring_out_R.push(right_in);
     }
   } else {
-    const uint offset = 2U * (left_out.size() - deque_out_L.size());
+    remove_noise(left_in, right_in, ring_out_L, ring_out_R);
+  }
+
+  const auto n_available = std::min(ring_out_L.read_available(), ring_out_R.read_available());
+
+  if (n_available < left_out.size()) {
+    const uint offset = 2U * (left_out.size() - n_available);
 
     if (offset != latency_n_frames) {
       latency_n_frames = offset;
 
       notify_latency = true;
     }
+  }
 
-    for (uint n = 0U; !deque_out_L.empty() && n < left_out.size(); n++) {
-      if (n < offset) {
-        left_out[n] = 0.0F;
-        right_out[n] = 0.0F;
-      } else {
-        left_out[n] = deque_out_L.front();
-        right_out[n] = deque_out_R.front();
+  const auto n_missing = (n_available < left_out.size()) ? left_out.size() - n_available : 0U;
 
-        deque_out_R.pop_front();
-        deque_out_L.pop_front();
-      }
-    }
-  }
+  std::fill(left_out.begin(), left_out.begin() + n_missing, 0.0F);
+  std::fill(right_out.begin(), right_out.begin() + n_missing, 0.0F);
+
+  ring_out_L.pop(left_out.subspan(n_missing));
+  ring_out_R.pop(right_out.subspan(n_missing));
 
   if (output_gain != 1.0F) {
     apply_gain(left_out, right_out, output_gain);
   }
 
   if (notify_latency) {
-    latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
+    // The overlap-add of the stereo link delays both channels by one more rnnoise frame. It is scaled to our rate.
+
+    const auto link_n_frames =
+        (channel_mode == ChannelMode::linked) ? static_cast<float>(blocksize * rate) / static_cast<float>(rnnoise_rate)
+                                              : 0.0F;
+
+    latency_value = (static_cast<float>(latency_n_frames) + link_n_frames) / static_cast<float>(rate);
 
     util::debug(log_tag + name + " latency: " + util::to_string(latency_value, "") + " s");
 
@@ -242,17 +289,11 @@ void RNNoise::process(std::span<float>& left_in,
   }
 }
 
-auto RNNoise::get_model_from_file() -> RNNModel* {
-  RNNModel* m = nullptr;
+auto RNNoise::get_model_from_file() -> RNNoiseModelCache::Model {
+  RNNoiseModelCache::Model m;
 
   if (const auto path = util::gsettings_get_string(settings, "model-path"); !path.empty()) {
-    if (FILE* f = fopen(path.c_str(), "r"); f != nullptr) {
-      util::debug(log_tag + name + " loading model from file: " + path);
-
-      m = rnnoise_model_from_file(f);
-
-      fclose(f);
-    }
+    m = RNNoiseModelCache::get().get_model(path);
   }
 
   if (m == nullptr) {
@@ -262,6 +303,38 @@ auto RNNoise::get_model_from_file() -> RNNModel* {
   return m;
 }
 
+void RNNoise::load_model() {
+  /*
+    The new states are created while the realtime thread keeps using the old ones. They are only swapped under the
+    lock, so there is no gap in the denoising and the realtime thread never sees a state that is being destroyed.
+  */
+
+  auto new_model = get_model_from_file();
+
+  auto* new_left = rnnoise_create(new_model.get());
+  auto* new_right = rnnoise_create(new_model.get());
+
+  {
+    std::scoped_lock<std::mutex> lock(data_mutex);
+
+    std::swap(model, new_model);
+    std::swap(state_left, new_left);
+    std::swap(state_right, new_right);
+
+    rnnoise_ready = true;
+  }
+
+  // the old states have to be destroyed before their model is released when new_model goes out of scope
+
+  if (new_left != nullptr) {
+    rnnoise_destroy(new_left);
+  }
+
+  if (new_right != nullptr) {
+    rnnoise_destroy(new_right);
+  }
+}
+
 void RNNoise::free_rnnoise() {
   rnnoise_ready = false;
 
@@ -273,13 +346,61 @@ void RNNoise::free_rnnoise() {
     rnnoise_destroy(state_right);
   }
 
-  if (model != nullptr) {
-    rnnoise_model_free(model);
-  }
-
   state_left = nullptr;
   state_right = nullptr;
-  model = nullptr;
+
+  model.reset();
+}
+
+void RNNoise::denoise_frame(DenoiseState* state, std::vector<float>& frame) {
+  if (state == nullptr) {
+    return;
+  }
+
+  std::ranges::for_each(frame, [](auto& v) { v *= static_cast<float>(SHRT_MAX + 1); });
+
+  if (state == state_left) {
+    // Only the left network is timed. The right one may be running at the same time in the fork join helper.
+
+    const auto start = std::chrono::steady_clock::now();
+
+    rnnoise_process_frame(state, frame.data(), frame.data());
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    frame_time = (frame_time == 0.0) ? elapsed.count() : 0.99 * frame_time + 0.01 * elapsed.count();
+  } else {
+    rnnoise_process_frame(state, frame.data(), frame.data());
+  }
+
+  std::ranges::for_each(frame, [&](auto& v) { v *= inv_short_max; });
+}
+
+void RNNoise::denoise_linked_frame() {
+  for (size_t n = 0U; n < blocksize; n++) {
+    data_mid[n] = 0.5F * (data_L[n] + data_R[n]);
+  }
+
+  std::copy(data_mid.begin(), data_mid.end(), denoised_mid.begin());
+
+  denoise_frame(state_left, denoised_mid);
+
+  stereo_link->process(data_L, data_R, data_mid, denoised_mid);
+}
+
+void RNNoise::report_savings() {
+  /*
+    Each saved frame is a network evaluation that did not happen. The mono mode also skips two resamplers when the
+    rate is not 48 kHz, but they are cheap compared to the network and are not counted.
+  */
+
+  const double frame_duration = static_cast<double>(blocksize) / static_cast<double>(rnnoise_rate);
+
+  const double saved = 100.0 * frame_time / frame_duration;
+
+  util::debug(log_tag + name + ((channel_mode == ChannelMode::mono) ? " mono" : " linked") +
+              " mode is saving about " + util::to_string(saved, "") + "% of a cpu core (" +
+              util::to_string(1000.0 * frame_time, "") + " ms per frame)");
 }
 
 auto RNNoise::get_latency_seconds() -> float {
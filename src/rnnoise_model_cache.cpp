@@ -0,0 +1,68 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "rnnoise_model_cache.hpp"
+
+auto RNNoiseModelCache::get() -> RNNoiseModelCache& {
+  static RNNoiseModelCache cache;
+
+  return cache;
+}
+
+auto RNNoiseModelCache::get_model(const std::string& path) -> Model {
+  std::scoped_lock<std::mutex> lock(models_mutex);
+
+  if (auto it = models.find(path); it != models.end()) {
+    if (auto model = it->second.lock()) {
+      util::debug(log_tag + "sharing the already loaded model: " + path);
+
+      return model;
+    }
+  }
+
+  FILE* f = fopen(path.c_str(), "r");
+
+  if (f == nullptr) {
+    util::warning(log_tag + "could not open the model file: " + path);
+
+    return nullptr;
+  }
+
+  util::debug(log_tag + "loading model from file: " + path);
+
+  auto* m = rnnoise_model_from_file(f);
+
+  fclose(f);
+
+  if (m == nullptr) {
+    util::warning(log_tag + "could not load the model file: " + path);
+
+    return nullptr;
+  }
+
+  // forgetting the models nobody uses anymore
+
+  std::erase_if(models, [](const auto& item) { return item.second.expired(); });
+
+  Model model(m, [](RNNModel* m) { rnnoise_model_free(m); });
+
+  models[path] = model;
+
+  return model;
+}
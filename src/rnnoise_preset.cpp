@@ -31,6 +31,8 @@ void RNNoisePreset::save(nlohmann::json& json, const std::string& section, GSett
   json[section]["rnnoise"]["output-gain"] = g_settings_get_double(settings, "output-gain");
 
   json[section]["rnnoise"]["model-path"] = util::gsettings_get_string(settings, "model-path");
+
+  json[section]["rnnoise"]["channel-mode"] = util::gsettings_get_string(settings, "channel-mode");
 }
 
 void RNNoisePreset::load(const nlohmann::json& json, const std::string& section, GSettings* settings) {
@@ -39,4 +41,6 @@ void RNNoisePreset::load(const nlohmann::json& json, const std::string& section,
   update_key<double>(json.at(section).at("rnnoise"), settings, "output-gain", "output-gain");
 
   update_key<gchar*>(json.at(section).at("rnnoise"), settings, "model-path", "model-path");
+
+  update_key<gchar*>(json.at(section).at("rnnoise"), settings, "channel-mode", "channel-mode");
 }
@@ -0,0 +1,166 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "rnnoise_stereo_link.hpp"
+
+RNNoiseStereoLink::RNNoiseStereoLink()
+    : window(window_size),
+      mid_delay(frame_size),
+      mid_in_history(window_size),
+      mid_out_history(window_size),
+      delay_L(frame_size),
+      delay_R(frame_size),
+      history_L(window_size),
+      history_R(window_size),
+      overlap_L(frame_size),
+      overlap_R(frame_size),
+      bin_gains(n_bins) {
+  // Vorbis power complementary window. The same rnnoise uses for its analysis and synthesis.
+
+  for (uint n = 0U; n < frame_size; n++) {
+    const double s = std::sin(0.5 * std::numbers::pi * (static_cast<double>(n) + 0.5) / frame_size);
+
+    window[n] = static_cast<float>(std::sin(0.5 * std::numbers::pi * s * s));
+
+    window[window_size - 1U - n] = window[n];
+  }
+
+  time_data = fftwf_alloc_real(window_size);
+  spectrum = fftwf_alloc_complex(n_bins);
+
+  forward_plan = fftwf_plan_dft_r2c_1d(static_cast<int>(window_size), time_data, spectrum, FFTW_ESTIMATE);
+  backward_plan = fftwf_plan_dft_c2r_1d(static_cast<int>(window_size), spectrum, time_data, FFTW_ESTIMATE);
+}
+
+RNNoiseStereoLink::~RNNoiseStereoLink() {
+  fftwf_destroy_plan(forward_plan);
+  fftwf_destroy_plan(backward_plan);
+
+  fftwf_free(time_data);
+  fftwf_free(spectrum);
+}
+
+void RNNoiseStereoLink::reset() {
+  for (auto* v : {&mid_delay, &mid_in_history, &mid_out_history, &delay_L, &delay_R, &history_L, &history_R,
+                  &overlap_L, &overlap_R}) {
+    std::ranges::fill(*v, 0.0F);
+  }
+}
+
+void RNNoiseStereoLink::process(std::span<float> left,
+                                std::span<float> right,
+                                std::span<const float> mid_in,
+                                std::span<const float> mid_out) {
+  // lining the network input up with its output, which comes one frame later
+
+  push_frame(mid_in_history, mid_delay);
+
+  std::copy(mid_in.begin(), mid_in.end(), mid_delay.begin());
+
+  push_frame(mid_out_history, mid_out);
+
+  analyze(mid_in_history, band_energy_in);
+  analyze(mid_out_history, band_energy_out);
+
+  for (uint b = 0U; b < n_bands; b++) {
+    const float gain = std::sqrt((band_energy_out[b] + 1e-9F) / (band_energy_in[b] + 1e-9F));
+
+    band_gains[b] = std::clamp(gain, 0.0F, 1.0F);
+  }
+
+  // linear interpolation between the bands like rnnoise does
+
+  for (uint b = 0U; b + 1U < n_bands; b++) {
+    const uint first = band_edges[b] * bins_per_edge;
+    const uint size = (band_edges[b + 1U] - band_edges[b]) * bins_per_edge;
+
+    for (uint j = 0U; j < size; j++) {
+      const float frac = static_cast<float>(j) / static_cast<float>(size);
+
+      bin_gains[first + j] = (1.0F - frac) * band_gains[b] + frac * band_gains[b + 1U];
+    }
+  }
+
+  std::fill(bin_gains.begin() + band_edges.back() * bins_per_edge, bin_gains.end(), band_gains.back());
+
+  apply_gains(left, delay_L, history_L, overlap_L);
+  apply_gains(right, delay_R, history_R, overlap_R);
+}
+
+void RNNoiseStereoLink::analyze(const std::vector<float>& history, std::array<float, n_bands>& band_energy) {
+  for (uint n = 0U; n < window_size; n++) {
+    time_data[n] = history[n] * window[n];
+  }
+
+  fftwf_execute(forward_plan);
+
+  band_energy.fill(0.0F);
+
+  // triangular bands like rnnoise compute_band_energy
+
+  for (uint b = 0U; b + 1U < n_bands; b++) {
+    const uint first = band_edges[b] * bins_per_edge;
+    const uint size = (band_edges[b + 1U] - band_edges[b]) * bins_per_edge;
+
+    for (uint j = 0U; j < size; j++) {
+      const float frac = static_cast<float>(j) / static_cast<float>(size);
+
+      const auto* bin = spectrum[first + j];
+
+      const float power = bin[0] * bin[0] + bin[1] * bin[1];
+
+      band_energy[b] += (1.0F - frac) * power;
+      band_energy[b + 1U] += frac * power;
+    }
+  }
+}
+
+void RNNoiseStereoLink::apply_gains(std::span<float> data,
+                                    std::vector<float>& delay,
+                                    std::vector<float>& history,
+                                    std::vector<float>& overlap) {
+  // delaying the channel by one frame so that it lines up with the gains
+
+  push_frame(history, delay);
+
+  std::copy(data.begin(), data.end(), delay.begin());
+
+  for (uint n = 0U; n < window_size; n++) {
+    time_data[n] = history[n] * window[n];
+  }
+
+  fftwf_execute(forward_plan);
+
+  // fftw does not normalize the inverse transform
+
+  const float scale = 1.0F / static_cast<float>(window_size);
+
+  for (uint k = 0U; k < n_bins; k++) {
+    spectrum[k][0] *= bin_gains[k] * scale;
+    spectrum[k][1] *= bin_gains[k] * scale;
+  }
+
+  fftwf_execute(backward_plan);
+
+  for (uint n = 0U; n < frame_size; n++) {
+    data[n] = overlap[n] + time_data[n] * window[n];
+
+    overlap[n] = time_data[frame_size + n] * window[frame_size + n];
+  }
+}
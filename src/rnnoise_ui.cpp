@@ -55,6 +55,8 @@ struct _RNNoiseBox {
 
   GtkToggleButton* bypass;
 
+  GtkComboBoxText* channel_mode;
+
   GtkListView* listview;
 
   GtkStringList* string_list;
@@ -174,18 +176,14 @@ void setup(RNNoiseBox* self,
 
   setup_listview(self);
 
-  self->data->connections.push_back(rnnoise->input_level.connect([=](const float& left, const float& right) {
-    update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                 self->input_level_right_label, left, right);
-  }));
-
-  self->data->connections.push_back(rnnoise->output_level.connect([=](const float& left, const float& right) {
-    update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                 self->output_level_right_label, left, right);
-  }));
+  add_level_meters_tick(GTK_WIDGET(self), rnnoise, self->input_level_left, self->input_level_left_label,
+                        self->input_level_right, self->input_level_right_label, self->output_level_left,
+                        self->output_level_left_label, self->output_level_right, self->output_level_right_label);
 
   gsettings_bind_widgets<"input-gain", "output-gain">(self->settings, self->input_gain, self->output_gain);
 
+  g_settings_bind(self->settings, "channel-mode", self->channel_mode, "active-id", G_SETTINGS_BIND_DEFAULT);
+
   g_settings_bind_with_mapping(
       self->settings, "model-path", self->selection_model, "selected", G_SETTINGS_BIND_DEFAULT,
       +[](GValue* value, GVariant* variant, gpointer user_data) {
@@ -296,6 +294,7 @@ void rnnoise_box_class_init(RNNoiseBoxClass* klass) {
   gtk_widget_class_bind_template_child(widget_class, RNNoiseBox, output_level_right_label);
 
   gtk_widget_class_bind_template_child(widget_class, RNNoiseBox, bypass);
+  gtk_widget_class_bind_template_child(widget_class, RNNoiseBox, channel_mode);
 
   gtk_widget_class_bind_template_child(widget_class, RNNoiseBox, string_list);
   gtk_widget_class_bind_template_child(widget_class, RNNoiseBox, selection_model);
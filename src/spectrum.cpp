@@ -23,16 +23,7 @@ Spectrum::Spectrum(const std::string& tag,
                    const std::string& schema,
                    const std::string& schema_path,
                    PipeManager* pipe_manager)
-    : PluginBase(tag, "spectrum", schema, schema_path, pipe_manager) {
-  real_input.resize(n_bands);
-  output.resize(n_bands / 2U + 1U);
-
-  complex_output = fftwf_alloc_complex(n_bands);
-
-  plan = fftwf_plan_dft_r2c_1d(static_cast<int>(n_bands), real_input.data(), complex_output, FFTW_ESTIMATE);
-
-  fftw_ready = true;
-
+    : PluginBase(tag, "spectrum", schema, schema_path, pipe_manager), tap(SpectrumAnalyzer::create_tap()) {
   g_signal_connect(settings, "changed::show", G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
                      auto self = static_cast<Spectrum*>(user_data);
 
@@ -41,6 +32,10 @@ Spectrum::Spectrum(const std::string& tag,
                      self->bypass = g_settings_get_boolean(settings, key) == 0;
                    }),
                    this);
+
+  // The main window decides through bypass whether samples are sent. The subscription lasts as long as the node.
+
+  SpectrumAnalyzer::get().subscribe(tap);
 }
 
 Spectrum::~Spectrum() {
@@ -48,23 +43,15 @@ Spectrum::~Spectrum() {
     disconnect_from_pw();
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
-
-  fftw_ready = false;
-
-  if (complex_output != nullptr) {
-    fftwf_free(complex_output);
-  }
-
-  fftwf_destroy_plan(plan);
+  SpectrumAnalyzer::get().unsubscribe(tap);
 
   util::debug(log_tag + name + " destroyed");
 }
 
 void Spectrum::setup() {
-  notification_dt = 0.0F;
+  std::scoped_lock<std::mutex> lock(data_mutex);
 
-  fft_buffer_duration = static_cast<float>(n_bands) / static_cast<float>(rate);
+  tap->set_rate(rate, n_samples);
 }
 
 void Spectrum::process(std::span<float>& left_in,
@@ -76,56 +63,17 @@ void Spectrum::process(std::span<float>& left_in,
   std::copy(left_in.begin(), left_in.end(), left_out.begin());
   std::copy(right_in.begin(), right_in.end(), right_out.begin());
 
-  if (bypass || !post_messages || !fftw_ready) {
+  if (bypass || !post_messages) {
     return;
   }
 
-  uint count = 0U;
-
-  for (uint n = 0U; n < left_in.size(); n++, count++) {
-    if (const uint k = total_count + n; k < real_input.size()) {
-      // https://en.wikipedia.org/wiki/Hann_function
-
-      const float w = 0.5F * (1.0F - std::cos(2.0F * std::numbers::pi_v<float> * static_cast<float>(k) /
-                                              static_cast<float>(real_input.size() - 1U)));
-
-      real_input[k] = 0.5F * (left_in[n] + right_in[n]) * w;
-    } else {
-      break;
-    }
-  }
-
-  total_count += count;
-
-  if (total_count == real_input.size()) {
-    total_count = 0U;
-
-    fftwf_execute(plan);
-
-    for (uint i = 0U; i < output.size(); i++) {
-      float sqr = complex_output[i][0] * complex_output[i][0] + complex_output[i][1] * complex_output[i][1];
-
-      sqr /= static_cast<float>(output.size() * output.size());
-
-      output[i] = sqr;
-    }
-  }
-
-  notification_dt += fft_buffer_duration;
-
-  if (notification_dt >= notification_time_window) {
-    notification_dt = 0.0F;
-
-    util::idle_add([=, this]() {
-      if (!post_messages) {
-        return;
-      }
+  tap->push(left_in, right_in);
+}
 
-      power.emit(rate, output.size(), output);
-    });
-  }
+auto Spectrum::get_frame(Frame& frame) -> bool {
+  return tap->get_frame(frame);
 }
 
 auto Spectrum::get_latency_seconds() -> float {
   return 0.0F;
-}
\ No newline at end of file
+}
@@ -0,0 +1,504 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "spectrum_analyzer.hpp"
+
+void SpectrumAnalyzer::Tap::set_rate(const uint& sampling_rate, const uint& n_samples) {
+  downmix.resize(n_samples);
+
+  rate.store(sampling_rate);
+}
+
+void SpectrumAnalyzer::Tap::push(std::span<const float> left, std::span<const float> right) {
+  if (!is_subscribed() || downmix.size() < left.size()) {
+    return;
+  }
+
+  for (size_t n = 0U; n < left.size(); n++) {
+    downmix[n] = 0.5F * (left[n] + right[n]);
+  }
+
+  // When the analyzer falls behind the newest samples are dropped. It will catch up on the next hop.
+
+  ring.push(std::span<const float>(downmix.data(), left.size()));
+}
+
+auto SpectrumAnalyzer::Tap::get_frame(Frame& frame) -> bool {
+  std::scoped_lock<std::mutex> lock(frame_mutex);
+
+  if (!new_frame) {
+    return false;
+  }
+
+  std::swap(frame, ready_frame);
+
+  new_frame = false;
+
+  return true;
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+    : settings(g_settings_new((tags::app::id + ".spectrum").c_str())),
+      window(n_bands),
+      real_input(n_bands),
+      output(n_bands / 2U + 1U),
+      short_window(n_short_bands),
+      short_input(n_short_bands),
+      bass_output(n_bands / 2U + 1U),
+      treble_output(n_short_bands / 2U + 1U),
+      decimation_filter(64U) {
+  // https://en.wikipedia.org/wiki/Hann_function
+
+  for (uint n = 0U; n < n_bands; n++) {
+    window[n] = 0.5F * (1.0F - std::cos(2.0F * std::numbers::pi_v<float> * static_cast<float>(n) /
+                                        static_cast<float>(n_bands - 1U)));
+  }
+
+  for (uint n = 0U; n < n_short_bands; n++) {
+    short_window[n] = 0.5F * (1.0F - std::cos(2.0F * std::numbers::pi_v<float> * static_cast<float>(n) /
+                                              static_cast<float>(n_short_bands - 1U)));
+  }
+
+  /*
+    Windowed sinc low pass for the decimation. The cutoff is 80% of the Nyquist frequency after decimation. The
+    bass transform only uses the bins below bass_crossover, far from it.
+  */
+
+  const float cutoff = 0.8F * 0.5F / static_cast<float>(decimation);  // cycles per input sample
+  const float center = 0.5F * static_cast<float>(decimation_filter.size() - 1U);
+
+  float sum = 0.0F;
+
+  for (size_t n = 0U; n < decimation_filter.size(); n++) {
+    const float t = static_cast<float>(n) - center;
+
+    const float sinc = (t == 0.0F) ? 2.0F * cutoff
+                                   : std::sin(2.0F * std::numbers::pi_v<float> * cutoff * t) /
+                                         (std::numbers::pi_v<float> * t);
+
+    // Blackman window
+
+    const float phase = 2.0F * std::numbers::pi_v<float> * static_cast<float>(n) /
+                        static_cast<float>(decimation_filter.size() - 1U);
+
+    decimation_filter[n] = sinc * (0.42F - 0.5F * std::cos(phase) + 0.08F * std::cos(2.0F * phase));
+
+    sum += decimation_filter[n];
+  }
+
+  std::ranges::for_each(decimation_filter, [&](auto& v) { v /= sum; });  // unity gain in the pass band
+
+  complex_output = fftwf_alloc_complex(n_bands);
+  short_complex_output = fftwf_alloc_complex(n_short_bands);
+
+  plan = fftwf_plan_dft_r2c_1d(static_cast<int>(n_bands), real_input.data(), complex_output, FFTW_ESTIMATE);
+
+  short_plan = fftwf_plan_dft_r2c_1d(static_cast<int>(n_short_bands), short_input.data(), short_complex_output,
+                                     FFTW_ESTIMATE);
+
+  for (const auto* key : {"changed::n-points", "changed::minimum-frequency", "changed::maximum-frequency",
+                          "changed::peak-hold", "changed::peak-decay", "changed::multi-resolution"}) {
+    g_signal_connect(settings, key, G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                       auto self = static_cast<SpectrumAnalyzer*>(user_data);
+
+                       std::scoped_lock<std::mutex> lock(self->analyzer_mutex);
+
+                       self->read_axis_settings();
+                     }),
+                     this);
+  }
+
+  read_axis_settings();
+
+  worker = std::thread([this]() { work(); });
+
+  // The display can wait. The analyzer must never compete with the audio threads.
+
+  sched_param param{};
+
+  if (pthread_setschedparam(worker.native_handle(), SCHED_IDLE, &param) != 0) {
+    util::debug(log_tag + "could not lower the analyzer thread priority");
+  }
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+  {
+    std::scoped_lock<std::mutex> lock(analyzer_mutex);
+
+    quit = true;
+  }
+
+  analyzer_cv.notify_one();
+
+  worker.join();
+
+  fftwf_destroy_plan(plan);
+  fftwf_destroy_plan(short_plan);
+
+  fftwf_free(complex_output);
+  fftwf_free(short_complex_output);
+
+  g_object_unref(settings);
+}
+
+auto SpectrumAnalyzer::get() -> SpectrumAnalyzer& {
+  static SpectrumAnalyzer analyzer;
+
+  return analyzer;
+}
+
+auto SpectrumAnalyzer::create_tap() -> std::shared_ptr<Tap> {
+  auto tap = std::make_shared<Tap>();
+
+  auto& self = get();
+
+  std::scoped_lock<std::mutex> lock(self.analyzer_mutex);
+
+  // Taps that were destroyed in the meantime leave expired entries behind
+
+  std::erase_if(self.taps, [](const auto& t) { return t.expired(); });
+
+  self.taps.push_back(tap);
+
+  return tap;
+}
+
+void SpectrumAnalyzer::subscribe(const std::shared_ptr<Tap>& tap) {
+  std::scoped_lock<std::mutex> lock(analyzer_mutex);
+
+  if (tap->n_subscribers.load() == 0) {
+    /*
+      Buffers are only allocated for taps somebody actually looks at. Neither the realtime thread nor the worker
+      touch them while there are no subscribers. Whatever was left in the ring from an earlier subscription only
+      shows up in the first frame.
+    */
+
+    if (tap->ring.capacity() == 0U) {
+      tap->ring.resize(4U * n_bands);
+
+      tap->history.resize(n_bands);
+      tap->hop_buffer.resize(n_bands);
+
+      tap->decimated_history.resize(n_bands);
+      tap->decimator_input.reserve(decimation_filter.size() + n_bands);
+    }
+
+    // The analyzer thread may still be working on this tap from an earlier subscription. It clears the state itself.
+
+    tap->reset_requested = true;
+  }
+
+  // Pairs with the acquire load in is_subscribed(). The realtime thread and the analyzer see the buffers resized above.
+
+  tap->n_subscribers.fetch_add(1, std::memory_order_release);
+}
+
+void SpectrumAnalyzer::unsubscribe(const std::shared_ptr<Tap>& tap) {
+  if (tap->n_subscribers.load() > 0) {
+    tap->n_subscribers--;
+  }
+}
+
+void SpectrumAnalyzer::read_axis_settings() {
+  n_points = static_cast<uint>(g_settings_get_int(settings, "n-points"));
+
+  minimum_frequency = static_cast<float>(g_settings_get_int(settings, "minimum-frequency"));
+  maximum_frequency = static_cast<float>(g_settings_get_int(settings, "maximum-frequency"));
+
+  config.serial++;
+
+  config.peak_hold = g_settings_get_boolean(settings, "peak-hold") != 0;
+  config.peak_decay = static_cast<float>(g_settings_get_double(settings, "peak-decay"));
+
+  if (const auto mode = g_settings_get_boolean(settings, "multi-resolution") != 0; mode != config.multi_resolution) {
+    config.multi_resolution = mode;
+
+    config.bins_serial++;
+  }
+
+  if (minimum_frequency > (maximum_frequency - 100.0F)) {
+    return;
+  }
+
+  if (auto new_axis = util::logspace(minimum_frequency, maximum_frequency, n_points); !new_axis.empty()) {
+    config.axis = std::move(new_axis);
+
+    config.axis_serial++;
+    config.bins_serial++;
+  }
+}
+
+void SpectrumAnalyzer::work() {
+  std::unique_lock<std::mutex> lock(analyzer_mutex);
+
+  const auto period = std::chrono::microseconds(static_cast<int64_t>(1000000.0F / display_rate));
+
+  while (!quit) {
+    analyzer_cv.wait_for(lock, period, [this]() { return quit; });
+
+    if (quit) {
+      break;
+    }
+
+    /*
+      The lock is only held while we take a snapshot of the taps and of the settings. The transforms run without it
+      so that the main thread never waits for them in create_tap, subscribe or the settings callbacks.
+    */
+
+    if (active_config.serial != config.serial) {
+      active_config = config;
+    }
+
+    for (const auto& weak_tap : taps) {
+      if (auto tap = weak_tap.lock(); tap != nullptr && tap->is_subscribed()) {
+        active_taps.push_back(std::move(tap));
+      }
+    }
+
+    lock.unlock();
+
+    // The UI picks the frames up from its frame clock. Nothing is scheduled in the main loop from here.
+
+    for (const auto& tap : active_taps) {
+      analyze(*tap);
+    }
+
+    active_taps.clear();
+
+    lock.lock();
+  }
+}
+
+auto SpectrumAnalyzer::analyze(Tap& tap) -> bool {
+  if (tap.reset_requested.exchange(false)) {
+    std::ranges::fill(tap.history, 0.0F);
+    std::ranges::fill(tap.decimated_history, 0.0F);
+
+    tap.decimator_input.clear();
+    tap.decimation_phase = 0U;
+
+    tap.bins_rate = 0U;
+  }
+
+  const auto sampling_rate = tap.rate.load();
+
+  if (sampling_rate == 0U) {
+    return false;
+  }
+
+  // A fixed hop gives frames at the display rate. It is capped so that no sample is ever skipped.
+
+  const auto hop = std::min(n_bands, static_cast<uint>(static_cast<float>(sampling_rate) / display_rate));
+
+  // Only the last frame is shown, so a backlog of hops just moves the history forward without transforms
+
+  bool has_hop = false;
+
+  while (tap.ring.read_available() >= hop) {
+    tap.ring.pop(std::span<float>(tap.hop_buffer.data(), hop));
+
+    std::copy(tap.history.begin() + hop, tap.history.end(), tap.history.begin());
+    std::copy(tap.hop_buffer.begin(), tap.hop_buffer.begin() + hop, tap.history.end() - hop);
+
+    if (active_config.multi_resolution) {
+      decimate(tap, std::span<const float>(tap.hop_buffer.data(), hop));
+    }
+
+    has_hop = true;
+  }
+
+  if (!has_hop) {
+    return false;
+  }
+
+  power_spectrum(tap.history, window, real_input, plan, complex_output, output);
+
+  if (active_config.multi_resolution) {
+    power_spectrum(tap.decimated_history, window, real_input, plan, complex_output, bass_output);
+
+    power_spectrum(std::span<const float>(tap.history).last(n_short_bands), short_window, short_input, short_plan,
+                   short_complex_output, treble_output);
+  }
+
+  if (tap.bins_rate != sampling_rate || tap.bins_serial != active_config.bins_serial) {
+    update_bins(tap, sampling_rate);
+  }
+
+  if (tap.bin_last.empty()) {
+    return false;
+  }
+
+  bin_frame(tap, static_cast<float>(hop) / static_cast<float>(sampling_rate));
+
+  std::scoped_lock<std::mutex> lock(tap.frame_mutex);
+
+  std::swap(tap.back_frame, tap.ready_frame);
+
+  tap.new_frame = true;
+
+  return true;
+}
+
+void SpectrumAnalyzer::decimate(Tap& tap, std::span<const float> hop) {
+  const auto taps = decimation_filter.size();
+
+  tap.decimator_input.insert(tap.decimator_input.end(), hop.begin(), hop.end());
+
+  if (tap.decimator_input.size() < taps) {
+    return;
+  }
+
+  /*
+    decimator_input holds the last taps - 1 samples of the previous hop followed by the new one. An output is made
+    every decimation samples, continuing from where the previous hop stopped.
+  */
+
+  uint n_outputs = 0U;
+  size_t start = tap.decimation_phase;
+
+  for (; start + taps <= tap.decimator_input.size(); start += decimation) {
+    tap.hop_buffer[n_outputs++] = std::inner_product(decimation_filter.begin(), decimation_filter.end(),
+                                                     tap.decimator_input.begin() + static_cast<long>(start), 0.0F);
+  }
+
+  const auto consumed = tap.decimator_input.size() - (taps - 1U);
+
+  tap.decimation_phase = static_cast<uint>(start - consumed);
+
+  tap.decimator_input.erase(tap.decimator_input.begin(), tap.decimator_input.begin() + static_cast<long>(consumed));
+
+  // hop_buffer is free again once the hop was copied to the history, so it is reused for the decimated samples
+
+  auto& history = tap.decimated_history;
+
+  std::copy(history.begin() + n_outputs, history.end(), history.begin());
+  std::copy(tap.hop_buffer.begin(), tap.hop_buffer.begin() + n_outputs, history.end() - n_outputs);
+}
+
+void SpectrumAnalyzer::power_spectrum(std::span<const float> input,
+                                      const std::vector<float>& window_table,
+                                      std::vector<float>& input_buffer,
+                                      fftwf_plan& fft_plan,
+                                      fftwf_complex* fft_output,
+                                      std::vector<float>& power) {
+  for (size_t n = 0U; n < input_buffer.size(); n++) {
+    input_buffer[n] = input[n] * window_table[n];
+  }
+
+  fftwf_execute(fft_plan);
+
+  for (size_t i = 0U; i < power.size(); i++) {
+    float sqr = fft_output[i][0] * fft_output[i][0] + fft_output[i][1] * fft_output[i][1];
+
+    sqr /= static_cast<float>(power.size() * power.size());
+
+    power[i] = sqr;
+  }
+}
+
+void SpectrumAnalyzer::update_bins(Tap& tap, const uint& sampling_rate) {
+  tap.bins_rate = sampling_rate;
+  tap.bins_serial = active_config.bins_serial;
+
+  const auto& axis = active_config.axis;
+
+  tap.bin_first.resize(axis.size());
+  tap.bin_last.resize(axis.size());
+  tap.bin_source.resize(axis.size());
+
+  tap.peaks.assign(axis.size(), util::minimum_db_level);
+
+  const auto rate = static_cast<float>(sampling_rate);
+
+  // Each point takes the bins above the previous point up to its own frequency
+
+  for (size_t n = 0U; n < axis.size(); n++) {
+    auto source = Resolution::mid;
+    auto size = n_bands;
+    auto bin_width = rate / static_cast<float>(n_bands);
+
+    if (active_config.multi_resolution && axis[n] < bass_crossover) {
+      source = Resolution::bass;
+      bin_width = rate / static_cast<float>(decimation * n_bands);
+    } else if (active_config.multi_resolution && axis[n] >= treble_crossover) {
+      source = Resolution::treble;
+      size = n_short_bands;
+      bin_width = rate / static_cast<float>(n_short_bands);
+    }
+
+    const auto n_bins = size / 2U + 1U;
+
+    const auto first =
+        (n == 0U) ? 0U : static_cast<uint>(std::max(std::floor(axis[n - 1U] / bin_width) + 1.0F, 0.0F));
+    const auto last = static_cast<uint>(std::max(std::floor(axis[n] / bin_width) + 1.0F, 0.0F));
+
+    tap.bin_source[n] = source;
+    tap.bin_first[n] = std::min(first, n_bins);
+    tap.bin_last[n] = std::min(last, n_bins);
+  }
+}
+
+void SpectrumAnalyzer::bin_frame(Tap& tap, const float& hop_seconds) {
+  auto& frame = tap.back_frame;
+
+  // The frame we got back from the UI may be older than the last axis change
+
+  if (frame.axis_serial != active_config.axis_serial) {
+    frame.frequencies = active_config.axis;
+    frame.axis_serial = active_config.axis_serial;
+  }
+
+  frame.magnitudes.resize(tap.bin_last.size());
+
+  const float decay = active_config.peak_decay * hop_seconds;
+
+  float previous = 0.0F;
+
+  for (size_t n = 0U; n < tap.bin_last.size(); n++) {
+    float sum = 0.0F;
+
+    const auto& power = (tap.bin_source[n] == Resolution::bass)     ? bass_output
+                        : (tap.bin_source[n] == Resolution::treble) ? treble_output
+                                                                    : output;
+
+    for (uint j = tap.bin_first[n]; j < tap.bin_last[n]; j++) {
+      sum += power[j];
+    }
+
+    // Points narrower than a bin repeat the previous one
+
+    if (tap.bin_first[n] == tap.bin_last[n]) {
+      sum = previous;
+    }
+
+    previous = sum;
+
+    auto v = 10.0F * std::log10(sum);
+
+    v = (!std::isinf(v) && v > util::minimum_db_level) ? v : util::minimum_db_level;
+
+    if (active_config.peak_hold) {
+      tap.peaks[n] = std::max(v, tap.peaks[n] - decay);
+
+      v = tap.peaks[n];
+    }
+
+    frame.magnitudes[n] = v;
+  }
+}
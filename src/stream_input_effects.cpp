@@ -151,7 +151,7 @@ void StreamInputEffects::on_app_added(const NodeInfo node_info) {
 }
 
 auto StreamInputEffects::apps_want_to_play() -> bool {
-  for (const auto& link : pm->list_links) {
+  for (const auto& link : pm->get_node_links(pm->ee_source_node.id)) {
     if (link.output_node_id == pm->ee_source_node.id) {
       if (link.state == PW_LINK_STATE_ACTIVE) {
         return true;
@@ -182,7 +182,7 @@ void StreamInputEffects::on_link_changed(const LinkInfo link_info) {
   }
 
   if (apps_want_to_play()) {
-    if (list_proxies.empty()) {
+    if (pipeline_links.empty()) {
       util::debug(log_tag + "At least one app linked to our device wants to play. Linking our filters.");
 
       connect_filters();
@@ -192,7 +192,7 @@ void StreamInputEffects::on_link_changed(const LinkInfo link_info) {
 
     g_timeout_add_seconds(
         inactivity_timeout, GSourceFunc(+[](StreamInputEffects* self) {
-          if (!self->apps_want_to_play() && !self->list_proxies.empty()) {
+          if (!self->apps_want_to_play() && !self->pipeline_links.empty()) {
             util::debug(self->log_tag + "No app linked to our device wants to play. Unlinking our filters.");
 
             self->disconnect_filters();
@@ -237,20 +237,16 @@ void StreamInputEffects::connect_filters(const bool& bypass) {
 
   // waiting for the input device ports information to be available.
 
-  int timeout = 0;
+  if (!pm->wait_node_ports(pm->input_device.id, 1U, PipeManager::ports_timeout)) {
+    util::warning(log_tag + "Information about the ports of the input device " + pm->input_device.name + " with id " +
+                  util::to_string(pm->input_device.id) + " are taking to long to be available. Aborting the link");
 
-  while (pm->count_node_ports(pm->input_device.id) < 1) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-
-    timeout++;
+    return;
+  }
 
-    if (timeout > 10000) {
-      util::warning(log_tag + "Information about the ports of the input device " + pm->input_device.name + " with id " +
-                    util::to_string(pm->input_device.id) + " are taking to long to be available. Aborting the link");
+  // The edges of the new pipeline. Only the difference to the current one is linked or unlinked.
 
-      return;
-    }
-  }
+  std::vector<PipelineEdge> edges;
 
   uint prev_node_id = pm->input_device.id;
   uint next_node_id = 0U;
@@ -266,15 +262,11 @@ void StreamInputEffects::connect_filters(const bool& bypass) {
       if (!plugins[name]->connected_to_pw ? plugins[name]->connect_to_pw() : true) {
         next_node_id = plugins[name]->get_node_id();
 
-        const auto links = pm->link_nodes(prev_node_id, next_node_id);
-
-        for (auto* link : links) {
-          list_proxies.push_back(link);
-        }
+        const auto n_links = add_pipeline_edge(edges, prev_node_id, next_node_id);
 
-        if (mic_linked && (links.size() == 2U)) {
+        if (mic_linked && (n_links == 2U)) {
           prev_node_id = next_node_id;
-        } else if (!mic_linked && (!links.empty())) {
+        } else if (!mic_linked && (n_links != 0U)) {
           prev_node_id = next_node_id;
           mic_linked = true;
         } else {
@@ -293,9 +285,7 @@ void StreamInputEffects::connect_filters(const bool& bypass) {
 
       if (name == plugin_name::echo_canceller) {
         if (plugins[name]->connected_to_pw) {
-          for (const auto& link : pm->link_nodes(pm->output_device.id, plugins[name]->get_node_id(), true)) {
-            list_proxies.push_back(link);
-          }
+          add_pipeline_edge(edges, pm->output_device.id, plugins[name]->get_node_id(), true);
         }
       }
 
@@ -308,15 +298,11 @@ void StreamInputEffects::connect_filters(const bool& bypass) {
   for (const auto node_id : {spectrum->get_node_id(), output_level->get_node_id(), pm->ee_source_node.id}) {
     next_node_id = node_id;
 
-    const auto links = pm->link_nodes(prev_node_id, next_node_id);
-
-    for (auto* link : links) {
-      list_proxies.push_back(link);
-    }
+    const auto n_links = add_pipeline_edge(edges, prev_node_id, next_node_id);
 
-    if (mic_linked && (links.size() == 2U)) {
+    if (mic_linked && (n_links == 2U)) {
       prev_node_id = next_node_id;
-    } else if (!mic_linked && (!links.empty())) {
+    } else if (!mic_linked && (n_links != 0U)) {
       prev_node_id = next_node_id;
       mic_linked = true;
     } else {
@@ -324,6 +310,8 @@ void StreamInputEffects::connect_filters(const bool& bypass) {
                     util::to_string(next_node_id) + " failed");
     }
   }
+
+  update_pipeline_links(edges);
 }
 
 void StreamInputEffects::disconnect_filters() {
@@ -333,43 +321,43 @@ void StreamInputEffects::disconnect_filters() {
       (bypass) ? std::vector<std::string>() : util::gchar_array_to_vector(g_settings_get_strv(settings, "plugins"));
 
   for (const auto& plugin : plugins | std::views::values) {
-    for (const auto& link : pm->list_links) {
-      if (link.input_node_id == plugin->get_node_id() || link.output_node_id == plugin->get_node_id()) {
-        link_id_list.insert(link.id);
-      }
-    }
-
-    if (plugin->connected_to_pw) {
-      if (std::ranges::find(selected_plugins_list, plugin->name) == selected_plugins_list.end()) {
-        util::debug(log_tag + "disconnecting the " + plugin->name + " filter from PipeWire");
-
-        plugin->disconnect_from_pw();
-      }
+    for (const auto& link : pm->get_node_links(plugin->get_node_id())) {
+      link_id_list.insert(link.id);
     }
   }
 
-  for (const auto& link : pm->list_links) {
-    if (link.input_node_id == spectrum->get_node_id() || link.output_node_id == spectrum->get_node_id() ||
-        link.input_node_id == output_level->get_node_id() || link.output_node_id == output_level->get_node_id()) {
+  disconnect_unused_plugins(selected_plugins_list);
+
+  for (const auto& node_id : {spectrum->get_node_id(), output_level->get_node_id()}) {
+    for (const auto& link : pm->get_node_links(node_id)) {
       link_id_list.insert(link.id);
     }
   }
 
+  LinkTransaction transaction(pm);
+
   for (const auto& id : link_id_list) {
-    pm->destroy_object(static_cast<int>(id));
+    transaction.destroy_object(id);
+  }
+
+  for (const auto& proxies : pipeline_links | std::views::values) {
+    transaction.destroy_links(proxies);
   }
 
-  pm->destroy_links(list_proxies);
+  transaction.commit();
 
-  list_proxies.clear();
+  pipeline_links.clear();
 }
 
 void StreamInputEffects::set_bypass(const bool& state) {
   bypass = state;
 
-  disconnect_filters();
+  // The new links are in place before the plugins that left the pipeline are removed from the graph
 
   connect_filters(state);
+
+  disconnect_unused_plugins((state) ? std::vector<std::string>()
+                                    : util::gchar_array_to_vector(g_settings_get_strv(settings, "plugins")));
 }
 
 void StreamInputEffects::set_listen_to_mic(const bool& state) {
@@ -151,7 +151,7 @@ void StreamOutputEffects::on_app_added(const NodeInfo node_info) {
 }
 
 auto StreamOutputEffects::apps_want_to_play() -> bool {
-  for (const auto& link : pm->list_links) {
+  for (const auto& link : pm->get_node_links(pm->ee_sink_node.id)) {
     if (link.input_node_id == pm->ee_sink_node.id) {
       if (link.state == PW_LINK_STATE_ACTIVE) {
         return true;
@@ -178,7 +178,7 @@ void StreamOutputEffects::on_link_changed(const LinkInfo link_info) {
   }
 
   if (apps_want_to_play()) {
-    if (list_proxies.empty()) {
+    if (pipeline_links.empty()) {
       util::debug(log_tag + "At least one app linked to our device wants to play. Linking our filters.");
 
       connect_filters();
@@ -188,7 +188,7 @@ void StreamOutputEffects::on_link_changed(const LinkInfo link_info) {
 
     g_timeout_add_seconds(
         inactivity_timeout, GSourceFunc(+[](StreamOutputEffects* self) {
-          if (!self->apps_want_to_play() && !self->list_proxies.empty()) {
+          if (!self->apps_want_to_play() && !self->pipeline_links.empty()) {
             util::debug(self->log_tag + "No app linked to our device wants to play. Unlinking our filters.");
 
             self->disconnect_filters();
@@ -204,6 +204,10 @@ void StreamOutputEffects::connect_filters(const bool& bypass) {
   const auto list =
       (bypass) ? std::vector<std::string>() : util::gchar_array_to_vector(g_settings_get_strv(settings, "plugins"));
 
+  // The edges of the new pipeline. Only the difference to the current one is linked or unlinked.
+
+  std::vector<PipelineEdge> edges;
+
   uint prev_node_id = pm->ee_sink_node.id;
   uint next_node_id = 0U;
 
@@ -218,13 +222,9 @@ void StreamOutputEffects::connect_filters(const bool& bypass) {
       if (!plugins[name]->connected_to_pw ? plugins[name]->connect_to_pw() : true) {
         next_node_id = plugins[name]->get_node_id();
 
-        const auto links = pm->link_nodes(prev_node_id, next_node_id);
-
-        for (auto* link : links) {
-          list_proxies.push_back(link);
-        }
+        const auto n_links = add_pipeline_edge(edges, prev_node_id, next_node_id);
 
-        if (links.size() == 2U) {
+        if (n_links == 2U) {
           prev_node_id = next_node_id;
         } else {
           util::warning(log_tag + " link from node " + util::to_string(prev_node_id) + " to node " +
@@ -242,9 +242,7 @@ void StreamOutputEffects::connect_filters(const bool& bypass) {
 
       if (name == plugin_name::echo_canceller) {
         if (plugins[name]->connected_to_pw) {
-          for (const auto& link : pm->link_nodes(pm->output_device.id, plugins[name]->get_node_id(), true)) {
-            list_proxies.push_back(link);
-          }
+          add_pipeline_edge(edges, pm->output_device.id, plugins[name]->get_node_id(), true);
         }
       }
 
@@ -257,13 +255,9 @@ void StreamOutputEffects::connect_filters(const bool& bypass) {
   for (const auto& node_id : {spectrum->get_node_id(), output_level->get_node_id()}) {
     next_node_id = node_id;
 
-    const auto links = pm->link_nodes(prev_node_id, next_node_id);
-
-    for (auto* link : links) {
-      list_proxies.push_back(link);
-    }
+    const auto n_links = add_pipeline_edge(edges, prev_node_id, next_node_id);
 
-    if (links.size() == 2U) {
+    if (n_links == 2U) {
       prev_node_id = next_node_id;
     } else {
       util::warning(log_tag + " link from node " + util::to_string(prev_node_id) + " to node " +
@@ -287,41 +281,35 @@ void StreamOutputEffects::connect_filters(const bool& bypass) {
     util::warning(log_tag + "The output device " + pm->output_device.name + " with id " +
                   util::to_string(pm->output_device.id) + " does not exist anymore. Aborting the link");
 
+    update_pipeline_links(edges);
+
     return;
   }
 
   // waiting for the output device ports information to be available.
 
-  int timeout = 0;
-
-  while (pm->count_node_ports(pm->output_device.id) < 2) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  if (!pm->wait_node_ports(pm->output_device.id, 2U, PipeManager::ports_timeout)) {
+    util::warning(log_tag + "Information about the ports of the output device " + pm->output_device.name +
+                  " with id " + util::to_string(pm->output_device.id) +
+                  " are taking to long to be available. Aborting the link");
 
-    timeout++;
+    update_pipeline_links(edges);
 
-    if (timeout > 10000) {  // 10 seconds
-      util::warning(log_tag + "Information about the ports of the output device " + pm->output_device.name +
-                    " with id " + util::to_string(pm->output_device.id) +
-                    " are taking to long to be available. Aborting the link");
-
-      return;
-    }
+    return;
   }
 
   // link output device
 
   next_node_id = pm->output_device.id;
 
-  const auto links = pm->link_nodes(prev_node_id, next_node_id);
-
-  for (auto* link : links) {
-    list_proxies.push_back(link);
-  }
+  const auto n_links = add_pipeline_edge(edges, prev_node_id, next_node_id);
 
-  if (links.size() < 2U) {
+  if (n_links < 2U) {
     util::warning(log_tag + " link from node " + util::to_string(prev_node_id) + " to output device " +
                   util::to_string(next_node_id) + " failed");
   }
+
+  update_pipeline_links(edges);
 }
 
 void StreamOutputEffects::disconnect_filters() {
@@ -331,41 +319,41 @@ void StreamOutputEffects::disconnect_filters() {
       (bypass) ? std::vector<std::string>() : util::gchar_array_to_vector(g_settings_get_strv(settings, "plugins"));
 
   for (const auto& plugin : plugins | std::views::values) {
-    for (const auto& link : pm->list_links) {
-      if (link.input_node_id == plugin->get_node_id() || link.output_node_id == plugin->get_node_id()) {
-        link_id_list.insert(link.id);
-      }
-    }
-
-    if (plugin->connected_to_pw) {
-      if (std::ranges::find(selected_plugins_list, plugin->name) == selected_plugins_list.end()) {
-        util::debug(log_tag + "disconnecting the " + plugin->name + " filter from PipeWire");
-
-        plugin->disconnect_from_pw();
-      }
+    for (const auto& link : pm->get_node_links(plugin->get_node_id())) {
+      link_id_list.insert(link.id);
     }
   }
 
-  for (const auto& link : pm->list_links) {
-    if (link.input_node_id == spectrum->get_node_id() || link.output_node_id == spectrum->get_node_id() ||
-        link.input_node_id == output_level->get_node_id() || link.output_node_id == output_level->get_node_id()) {
+  disconnect_unused_plugins(selected_plugins_list);
+
+  for (const auto& node_id : {spectrum->get_node_id(), output_level->get_node_id()}) {
+    for (const auto& link : pm->get_node_links(node_id)) {
       link_id_list.insert(link.id);
     }
   }
 
+  LinkTransaction transaction(pm);
+
   for (const auto& id : link_id_list) {
-    pm->destroy_object(static_cast<int>(id));
+    transaction.destroy_object(id);
   }
 
-  pm->destroy_links(list_proxies);
+  for (const auto& proxies : pipeline_links | std::views::values) {
+    transaction.destroy_links(proxies);
+  }
 
-  list_proxies.clear();
+  transaction.commit();
+
+  pipeline_links.clear();
 }
 
 void StreamOutputEffects::set_bypass(const bool& state) {
   bypass = state;
 
-  disconnect_filters();
+  // The new links are in place before the plugins that left the pipeline are removed from the graph
 
   connect_filters(state);
+
+  disconnect_unused_plugins((state) ? std::vector<std::string>()
+                                    : util::gchar_array_to_vector(g_settings_get_strv(settings, "plugins")));
 }
@@ -1,4 +1,38 @@
 #include "ui_helpers.hpp"
+#include "plugin_base.hpp"
+
+namespace {
+
+struct TickCallback {
+  std::function<void()> callback;
+
+  guint tick_id = 0U;
+};
+
+void on_tick_widget_map(GtkWidget* widget, TickCallback* tc) {
+  if (tc->tick_id != 0U) {
+    return;
+  }
+
+  tc->tick_id = gtk_widget_add_tick_callback(
+      widget,
+      +[](GtkWidget* widget, GdkFrameClock* clock, gpointer user_data) {
+        static_cast<TickCallback*>(user_data)->callback();
+
+        return G_SOURCE_CONTINUE;
+      },
+      tc, nullptr);
+}
+
+void on_tick_widget_unmap(GtkWidget* widget, TickCallback* tc) {
+  if (tc->tick_id != 0U) {
+    gtk_widget_remove_tick_callback(widget, tc->tick_id);
+
+    tc->tick_id = 0U;
+  }
+}
+
+}  // namespace
 
 namespace ui {
 
@@ -73,6 +107,43 @@ void update_level(GtkLevelBar* w_left,
   }
 }
 
+void add_tick_callback(GtkWidget* widget, std::function<void()> callback) {
+  auto* tc = new TickCallback{std::move(callback)};
+
+  // The map handler owns tc. It is freed when the handlers are destroyed together with the widget.
+
+  g_signal_connect_data(
+      widget, "map", G_CALLBACK(on_tick_widget_map), tc,
+      +[](gpointer data, GClosure* closure) { delete static_cast<TickCallback*>(data); },
+      static_cast<GConnectFlags>(0));
+
+  g_signal_connect(widget, "unmap", G_CALLBACK(on_tick_widget_unmap), tc);
+
+  if (gtk_widget_get_mapped(widget) != 0) {
+    on_tick_widget_map(widget, tc);
+  }
+}
+
+void add_level_meters_tick(GtkWidget* widget,
+                           std::shared_ptr<PluginBase> plugin,
+                           GtkLevelBar* input_left,
+                           GtkLabel* input_left_label,
+                           GtkLevelBar* input_right,
+                           GtkLabel* input_right_label,
+                           GtkLevelBar* output_left,
+                           GtkLabel* output_left_label,
+                           GtkLevelBar* output_right,
+                           GtkLabel* output_right_label) {
+  add_tick_callback(widget, [=, serial = 0U, levels = PluginBase::Levels()]() mutable {
+    if (plugin->get_levels(levels, serial)) {
+      update_level(input_left, input_left_label, input_right, input_right_label, levels.input_left, levels.input_right);
+
+      update_level(output_left, output_left_label, output_right, output_right_label, levels.output_left,
+                   levels.output_right);
+    }
+  });
+}
+
 void append_to_string_list(GtkStringList* string_list, const std::string& name) {
   for (guint n = 0U; n < g_list_model_get_n_items(G_LIST_MODEL(string_list)); n++) {
     if (gtk_string_list_get_string(string_list, n) == name) {
@@ -18,6 +18,8 @@
  */
 
 #include "util.hpp"
+#include <pthread.h>
+#include <sched.h>
 
 namespace util {
 
@@ -45,6 +47,18 @@ void print_thread_id() {
   std::cout << "thread id: " << std::this_thread::get_id() << std::endl;
 }
 
+auto get_realtime_priority() -> int {
+  int policy = 0;
+
+  sched_param param{};
+
+  if (pthread_getschedparam(pthread_self(), &policy, &param) != 0 || (policy != SCHED_FIFO && policy != SCHED_RR)) {
+    return 0;
+  }
+
+  return param.sched_priority;
+}
+
 auto logspace(const float& start, const float& stop, const uint& npoints) -> std::vector<float> {
   std::vector<float> output;
 
@@ -0,0 +1,120 @@
+/*
+ *  Copyright © 2017-2022 Wellington Wallace
+ *
+ *  This file is part of EasyEffects.
+ *
+ *  EasyEffects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EasyEffects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EasyEffects.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "waveform_pyramid.hpp"
+
+namespace {
+
+constexpr size_t min_level_size = 64U;
+
+}  // namespace
+
+void WaveformPyramid::build(std::span<const float> signal, const float& sample_period) {
+  dt = sample_period;
+
+  samples.assign(signal.begin(), signal.end());
+
+  level_min.clear();
+  level_max.clear();
+
+  // The first level pairs the samples. Every other level pairs the blocks of the level below it.
+
+  const auto* lower_min = &samples;
+  const auto* lower_max = &samples;
+
+  while (lower_min->size() > min_level_size) {
+    const auto n_blocks = (lower_min->size() + 1U) / 2U;
+
+    std::vector<float> mins(n_blocks);
+    std::vector<float> maxs(n_blocks);
+
+    for (size_t n = 0U; n < n_blocks; n++) {
+      const auto first = 2U * n;
+      const auto second = std::min(first + 1U, lower_min->size() - 1U);
+
+      mins[n] = std::min((*lower_min)[first], (*lower_min)[second]);
+      maxs[n] = std::max((*lower_max)[first], (*lower_max)[second]);
+    }
+
+    level_min.push_back(std::move(mins));
+    level_max.push_back(std::move(maxs));
+
+    lower_min = &level_min.back();
+    lower_max = &level_max.back();
+  }
+}
+
+void WaveformPyramid::query(const uint& n_columns, std::vector<float>& x, std::vector<float>& y) const {
+  x.clear();
+  y.clear();
+
+  if (samples.empty() || n_columns == 0U) {
+    return;
+  }
+
+  // Short signals are plotted as they are
+
+  if (samples.size() <= 2U * n_columns) {
+    x.resize(samples.size());
+
+    for (size_t n = 0U; n < samples.size(); n++) {
+      x[n] = static_cast<float>(n) * dt;
+    }
+
+    y = samples;
+
+    return;
+  }
+
+  // The finest level whose blocks still fit in a column. Level 0 is the signal itself.
+
+  const auto samples_per_column = samples.size() / n_columns;
+
+  size_t level = 0U;
+
+  while (level < level_min.size() && (size_t{2U} << level) <= samples_per_column) {
+    level++;
+  }
+
+  const auto& mins = (level == 0U) ? samples : level_min[level - 1U];
+  const auto& maxs = (level == 0U) ? samples : level_max[level - 1U];
+
+  const auto n_blocks = mins.size();
+
+  const float column_duration = static_cast<float>(samples.size()) * dt / static_cast<float>(n_columns);
+
+  x.resize(2U * n_columns);
+  y.resize(2U * n_columns);
+
+  for (size_t c = 0U; c < n_columns; c++) {
+    const auto first = c * n_blocks / n_columns;
+    const auto last = std::max(first + 1U, (c + 1U) * n_blocks / n_columns);
+
+    const auto column_min = *std::min_element(mins.begin() + first, mins.begin() + last);
+    const auto column_max = *std::max_element(maxs.begin() + first, maxs.begin() + last);
+
+    const float t = static_cast<float>(c) * column_duration;
+
+    x[2U * c] = t;
+    x[2U * c + 1U] = t + 0.5F * column_duration;
+
+    y[2U * c] = column_min;
+    y[2U * c + 1U] = column_max;
+  }
+}